@@ -0,0 +1,34 @@
+#include "OneMachineDP.h"
+
+#ifdef OMDP_ALLOC_PROFILE
+#include <new>
+
+thread_local OneMachDPProfile* tAllocProfile = nullptr;
+thread_local int tAllocPhase = 0;
+
+/************************************************************************************************************
+ * Global allocation hook of the allocation profiling build. Array and nothrow forms reach it through the	*
+ * library defaults; the profile is only touched by the thread that runs its search							*
+ ************************************************************************************************************/
+void* operator new(size_t size)
+{
+	if (tAllocProfile != nullptr) {
+		tAllocProfile->mAllocs[tAllocPhase]++;
+		tAllocProfile->mAllocBytes[tAllocPhase] += size;
+	}
+	void* ptr = malloc(size == 0 ? 1 : size);
+	if (ptr == nullptr)
+		throw bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	free(ptr);
+}
+#endif
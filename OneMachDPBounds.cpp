@@ -13,6 +13,7 @@ void OneMachDPBounds::initialize()
  ************************************************************************************************************/
 int OneMachDPBounds::getLBStd(OneMachDPNode* node)
 {
+	PROFILE_SCOPE(mOneMachDPData->mProfile, profGetLBStd);
 	int curTime = 0, stopTime, bound = 0;
 	int count = 0, temp = 0;
 	int jobSetAvalCount = 0;
@@ -21,6 +22,7 @@ int OneMachDPBounds::getLBStd(OneMachDPNode* node)
 	JobStep* step;
 	JobStep* next;
 	list<JobStep*> unschd;
+	vector<JobStep*>& jobs = mOneMachDPData->mJobsByIndex;
 	vector<int> jobScheduled;
 	// availableJobSteps stores job steps that don't have unscheduled predecessor, ordered in ascending by head value
 	minHeadQueue availableJobSteps(stepComp(3));
@@ -34,7 +36,7 @@ int OneMachDPBounds::getLBStd(OneMachDPNode* node)
 		jobIndex = step->jobIndex;
 		step->remTime = step->body;
 		step->curHead = step->head;
-		if (node->mAllPreds[jobIndex].empty()) {
+		if (node->mAllPreds.empty(jobIndex)) {
 			availableJobSteps.push(step);
 			jobSetAvalCount++;
 		}
@@ -103,12 +105,12 @@ int OneMachDPBounds::getLBStd(OneMachDPNode* node)
 			*    completely.																						*
 			********************************************************************************************************/
 			jobIndex = step->jobIndex;
-			for (auto succJob = node->mAllSuccs[jobIndex].begin();
-				succJob != node->mAllSuccs[jobIndex].end(); succJob++) {
+			for (int k = node->mAllSuccs.begin(jobIndex); k < node->mAllSuccs.end(jobIndex); k++) {
+				fixedEdge& succFix = node->allFixes[node->mAllSuccs.edges[k]];
 				temp = curTime;
-				if ((*succJob)->to->curHead < temp)
-					(*succJob)->to->curHead = temp;
-				unschd.push_back((*succJob)->to);
+				if (jobs[succFix.to]->curHead < temp)
+					jobs[succFix.to]->curHead = temp;
+				unschd.push_back(jobs[succFix.to]);
 			}
 		} else {
 			// Current jobstep is not finished when the next available jobstep is released
@@ -127,9 +129,9 @@ int OneMachDPBounds::getLBStd(OneMachDPNode* node)
 				jobIndex = step->jobIndex;
 				bool predDone = true;
 				// Check the predecessor list for each unscheduled jobs to see if all predecessor scheduled
-				for (auto predJob = node->mAllPreds[jobIndex].begin();
-					predJob != node->mAllPreds[jobIndex].end(); predJob++) {
-					int ind = (*predJob)->from->jobIndex;
+				for (int k = node->mAllPreds.begin(jobIndex); k < node->mAllPreds.end(jobIndex); k++) {
+					fixedEdge& predFix = node->allFixes[node->mAllPreds.edges[k]];
+					int ind = predFix.from;
 					// if (node->mJobScheduled[ind] == 0) {
 					if (jobScheduled[ind] == -1) {
 						predDone = false;
@@ -153,6 +155,7 @@ int OneMachDPBounds::getLBStd(OneMachDPNode* node)
 
 int OneMachDPBounds::getLBStd(OneMachDPNode* node, list<JobStep*> &jobsToSchd)
 {
+	PROFILE_SCOPE(mOneMachDPData->mProfile, profGetLBStd);
 	int curTime = 0, stopTime, bound = 0;
 	int count = 0, temp = 0;
 	int jobSetAvalCount = 0;
@@ -161,6 +164,7 @@ int OneMachDPBounds::getLBStd(OneMachDPNode* node, list<JobStep*> &jobsToSchd)
 	JobStep* step;
 	JobStep* next;
 	list<JobStep*> unschd;
+	vector<JobStep*>& jobs = mOneMachDPData->mJobsByIndex;
 	vector<int> jobScheduled;
 	// availableJobSteps stores job steps that don't have unscheduled predecessor, ordered in ascending by head value
 	minHeadQueue availableJobSteps(stepComp(3));
@@ -174,7 +178,7 @@ int OneMachDPBounds::getLBStd(OneMachDPNode* node, list<JobStep*> &jobsToSchd)
 		jobIndex = step->jobIndex;
 		step->remTime = step->body;
 		step->curHead = step->head;
-		if (node->mAllPreds[jobIndex].empty()) {
+		if (node->mAllPreds.empty(jobIndex)) {
 			availableJobSteps.push(step);
 			jobSetAvalCount++;
 		}
@@ -245,12 +249,12 @@ int OneMachDPBounds::getLBStd(OneMachDPNode* node, list<JobStep*> &jobsToSchd)
 			*    completely.																						*
 			********************************************************************************************************/
 			jobIndex = step->jobIndex;
-			for (auto succJob = node->mAllSuccs[jobIndex].begin();
-				succJob != node->mAllSuccs[jobIndex].end(); succJob++) {
+			for (int k = node->mAllSuccs.begin(jobIndex); k < node->mAllSuccs.end(jobIndex); k++) {
+				fixedEdge& succFix = node->allFixes[node->mAllSuccs.edges[k]];
 				temp = curTime;
-				if ((*succJob)->to->curHead < temp)
-					(*succJob)->to->curHead = temp;
-				unschd.push_back((*succJob)->to);
+				if (jobs[succFix.to]->curHead < temp)
+					jobs[succFix.to]->curHead = temp;
+				unschd.push_back(jobs[succFix.to]);
 			}
 		}
 		else {
@@ -270,9 +274,9 @@ int OneMachDPBounds::getLBStd(OneMachDPNode* node, list<JobStep*> &jobsToSchd)
 				jobIndex = step->jobIndex;
 				bool predDone = true;
 				// Check the predecessor list for each unscheduled jobs to see if all predecessor scheduled
-				for (auto predJob = node->mAllPreds[jobIndex].begin();
-					predJob != node->mAllPreds[jobIndex].end(); predJob++) {
-					int ind = (*predJob)->from->jobIndex;
+				for (int k = node->mAllPreds.begin(jobIndex); k < node->mAllPreds.end(jobIndex); k++) {
+					fixedEdge& predFix = node->allFixes[node->mAllPreds.edges[k]];
+					int ind = predFix.from;
 					// if (node->mJobScheduled[ind] == 0) {
 					if (jobScheduled[ind] == -1) {
 						predDone = false;
@@ -328,6 +332,7 @@ int OneMachDPBounds::getLBFromSol(OneMachDPNode* node)
  ************************************************************************************************************/
 int OneMachDPBounds::getUB(OneMachDPNode* node)
 {
+	PROFILE_SCOPE(mOneMachDPData->mProfile, profGetUB);
 	int curTime = 0;
 	int maxTime = 0, temp = 0;
 	int jobSetAvalCount = 0;
@@ -337,6 +342,7 @@ int OneMachDPBounds::getUB(OneMachDPNode* node)
 	JobStep* prev;
 	JobStep* tempStep;
 	list<JobStep*> unschd;
+	vector<JobStep*>& jobs = mOneMachDPData->mJobsByIndex;
 	// availableJobSteps stores job steps that don't have unscheduled predecessor, ordered in ascending by head value
 	minHeadQueue availableJobSteps(stepComp(3));
 	// releaseJobSteps stores job steps that is not only available, but is released, ordered in descending by tail value
@@ -351,7 +357,7 @@ int OneMachDPBounds::getUB(OneMachDPNode* node)
 		step = &*iter;
 		jobIndex = step->jobIndex;
 		step->curHead = step->head;
-		if (node->mAllPreds[jobIndex].empty()) {
+		if (node->mAllPreds.empty(jobIndex)) {
 			availableJobSteps.push(step);
 			jobSetAvalCount++;
 		}
@@ -397,12 +403,12 @@ int OneMachDPBounds::getUB(OneMachDPNode* node)
 		 * 3. Update the release date of successors of the job being scheduled, if necessary.                       *
 		 ************************************************************************************************************/
 		jobIndex = step->jobIndex;
-		for (auto succJob = node->mAllSuccs[jobIndex].begin(); 
-				succJob != node->mAllSuccs[jobIndex].end(); succJob++) {
-			temp = (*succJob)->delay + curTime;
-			if ((*succJob)->to->curHead < temp)
-				(*succJob)->to->curHead = temp;
-			unschd.push_back((*succJob)->to);
+		for (int k = node->mAllSuccs.begin(jobIndex); k < node->mAllSuccs.end(jobIndex); k++) {
+			fixedEdge& succFix = node->allFixes[node->mAllSuccs.edges[k]];
+			temp = succFix.delay + curTime;
+			if (jobs[succFix.to]->curHead < temp)
+				jobs[succFix.to]->curHead = temp;
+			unschd.push_back(jobs[succFix.to]);
 		}
 		/************************************************************************************************************
 		 * 4. Put the job in existing schedule, keep track of scheduled jobs, and clean up.                         *
@@ -423,9 +429,9 @@ int OneMachDPBounds::getUB(OneMachDPNode* node)
 				jobIndex = step->jobIndex;
 				bool predDone = true;
 				// Check the predecessor list for each unscheduled jobs to see if all predecessor scheduled
-				for (auto predJob = node->mAllPreds[jobIndex].begin();
-					predJob != node->mAllPreds[jobIndex].end(); predJob++) {
-					int ind = (*predJob)->from->jobIndex;
+				for (int k = node->mAllPreds.begin(jobIndex); k < node->mAllPreds.end(jobIndex); k++) {
+					fixedEdge& predFix = node->allFixes[node->mAllPreds.edges[k]];
+					int ind = predFix.from;
 					if (node->mJobScheduled[ind] == -1) {
 						predDone = false;
 						break;
@@ -449,6 +455,129 @@ int OneMachDPBounds::getUB(OneMachDPNode* node)
 	return curSol;
 }
 
+/************************************************************************************************************
+ * The longest tail heuristic algorithm on the reverse problem. Heads and tails are swapped and precedence	*
+ * arcs of node are traversed backwards, so no reverse node needs to be built. revSolPath receives the		*
+ * reverse schedule in forward order. Job step heads and tails are restored from node before returning.	*
+ ************************************************************************************************************/
+int OneMachDPBounds::getUBRev(OneMachDPNode* node, list<JobStep*> &revSolPath)
+{
+	int curTime = 0;
+	int maxTime = 0, temp = 0;
+	int jobSetAvalCount = 0;
+	int schdJobCount = 0;
+	int jobIndex;
+	JobStep* step;
+	list<JobStep*> unschd;
+	vector<JobStep*>& jobs = mOneMachDPData->mJobsByIndex;
+	vector<int> jobScheduled;
+	// availableJobSteps stores job steps that don't have unscheduled predecessor, ordered in ascending by head value
+	minHeadQueue availableJobSteps(stepComp(3));
+	// releaseJobSteps stores job steps that is not only available, but is released, ordered in descending by tail value
+	maxTailQueue releaseJobSteps(stepComp(2));
+	list<JobStep>::iterator iter = mOneMachDPData->mJobsData.begin();
+	list<JobStep>::iterator end = mOneMachDPData->mJobsData.end();
+
+	// Initialize: 1. use tail as head and head as tail
+	//			   2. move jobs to available pool if it does not have any successors
+	while (iter != end) {
+		step = &*iter;
+		jobIndex = step->jobIndex;
+		step->head = node->mUpdatedTail[jobIndex];
+		step->tail = node->mUpdatedHead[jobIndex];
+		step->curHead = step->head;
+		if (node->mAllSuccs.empty(jobIndex)) {
+			availableJobSteps.push(step);
+			jobSetAvalCount++;
+		}
+		iter++;
+	}
+	jobScheduled.resize(mNumJobSteps, -1);
+	revSolPath.clear();
+	// Sanity check. The first job should always be able to be added to queue
+	step = availableJobSteps.top();
+	if (curTime < step->curHead) curTime = step->curHead;
+
+	while (schdJobCount < mNumJobSteps)
+	{
+		/************************************************************************************************************
+		 * 1. Among all available jobs, find the ones that are released. Push into released job step poll.			*
+		 *	  If none, move curTime to the starting time of the first job in available list and try again.          *
+		 ************************************************************************************************************/
+		while (!availableJobSteps.empty()) {
+			step = availableJobSteps.top();
+			if (step->curHead <= curTime) {
+				releaseJobSteps.push(step);
+				availableJobSteps.pop();
+			} else if (releaseJobSteps.empty()) {
+				curTime = step->curHead;
+				releaseJobSteps.push(step);
+				availableJobSteps.pop();
+			} else
+				break;
+		}
+		/************************************************************************************************************
+		 * 2. Get the next job to schedule.																			*
+		 ************************************************************************************************************/
+		step = releaseJobSteps.top();						// The step to schedule next
+		jobScheduled[step->jobIndex] = curTime;				// Record starting time of job step
+		curTime += step->body;
+		if (curTime + step->tail > maxTime) {
+			maxTime = curTime + step->tail;
+		}
+
+		/************************************************************************************************************
+		 * 3. Update the release date of predecessors (successors in reverse problem), if necessary.				*
+		 ************************************************************************************************************/
+		jobIndex = step->jobIndex;
+		for (int k = node->mAllPreds.begin(jobIndex); k < node->mAllPreds.end(jobIndex); k++) {
+			fixedEdge& predFix = node->allFixes[node->mAllPreds.edges[k]];
+			temp = predFix.delay + curTime;
+			if (jobs[predFix.from]->curHead < temp)
+				jobs[predFix.from]->curHead = temp;
+			unschd.push_back(jobs[predFix.from]);
+		}
+		/************************************************************************************************************
+		 * 4. Put the job in existing schedule (in front, as the reverse schedule is read backwards).				*
+		 ************************************************************************************************************/
+		revSolPath.push_front(step);
+		schdJobCount++;
+		releaseJobSteps.pop();
+
+		/************************************************************************************************************
+		* 5. For all the unscheduled jobs, the ones whoes successors have all been scheduled is put					*
+		*	  in a priority queue so they are sorted by head.														*
+		************************************************************************************************************/
+		if (!unschd.empty()) {
+			auto unsJobIter = unschd.begin();
+			while (unsJobIter != unschd.end()) {
+				step = *unsJobIter;
+				jobIndex = step->jobIndex;
+				bool succDone = true;
+				for (int k = node->mAllSuccs.begin(jobIndex); k < node->mAllSuccs.end(jobIndex); k++) {
+					fixedEdge& succFix = node->allFixes[node->mAllSuccs.edges[k]];
+					if (jobScheduled[succFix.to] == -1) {
+						succDone = false;
+						break;
+					}
+				}
+				if (succDone) {
+					availableJobSteps.push(step);
+					jobSetAvalCount++;
+				}
+				unsJobIter++;
+			}
+			unschd.clear();
+		}
+	}
+	if (jobSetAvalCount != mNumJobSteps)
+		throw ERROR << "Not all job step can be scheduled, check precedence constraints.";
+	// Reset curHead, heads and tails
+	node->resetcurHead();
+	node->doedge();
+	return maxTime;
+}
+
 /************************************************************************************************************
  * OneMachDPBounds::getUBMod(OneMachDPNode* node):															*
  * The longest tail heuristic algorithm for DPCs, with modified procedure									*
@@ -465,6 +594,7 @@ int OneMachDPBounds::getUBMod(OneMachDPNode* node)
 	JobStep* prev;
 	JobStep* tempStep;
 	list<JobStep*> unschd;
+	vector<JobStep*>& jobs = mOneMachDPData->mJobsByIndex;
 	// availableJobSteps stores job steps that don't have unscheduled predecessor, ordered in ascending by head value
 	minHeadQueue availableJobSteps(stepComp(3));
 	// releaseJobSteps stores job steps that is not only available, but is released, ordered in descending by tail value
@@ -479,7 +609,7 @@ int OneMachDPBounds::getUBMod(OneMachDPNode* node)
 		step = &*iter;
 		jobIndex = step->jobIndex;
 		step->curHead = step->head;
-		if (node->mAllPreds[jobIndex].empty()) {
+		if (node->mAllPreds.empty(jobIndex)) {
 			availableJobSteps.push(step);
 			jobSetAvalCount++;
 		}
@@ -526,14 +656,14 @@ int OneMachDPBounds::getUBMod(OneMachDPNode* node)
 		 * 3. Update the release date of successors of the job being scheduled, if necessary.                       *
 		 ************************************************************************************************************/
 		jobIndex = step->jobIndex;
-		for (auto succJob = node->mAllSuccs[jobIndex].begin();
-			succJob != node->mAllSuccs[jobIndex].end(); succJob++) {
-			temp = (*succJob)->delay + curTime;
-			if ((*succJob)->to->curHead < temp) {
-				(*succJob)->to->curHead = temp;
-				updtIndex = (*succJob)->to->jobIndex;
+		for (int k = node->mAllSuccs.begin(jobIndex); k < node->mAllSuccs.end(jobIndex); k++) {
+			fixedEdge& succFix = node->allFixes[node->mAllSuccs.edges[k]];
+			temp = succFix.delay + curTime;
+			if (jobs[succFix.to]->curHead < temp) {
+				jobs[succFix.to]->curHead = temp;
+				updtIndex = succFix.to;
 			}
-			unschd.push_back((*succJob)->to);
+			unschd.push_back(jobs[succFix.to]);
 		}
 		/************************************************************************************************************
 		 * 4. Put the job in existing schedule, keep track of scheduled jobs, and clean up.                         *
@@ -554,9 +684,9 @@ int OneMachDPBounds::getUBMod(OneMachDPNode* node)
 				jobIndex = step->jobIndex;
 				bool predDone = true;
 				// Check the predecessor list for each unscheduled jobs to see if all predecessor scheduled
-				for (auto predJob = node->mAllPreds[jobIndex].begin();
-					predJob != node->mAllPreds[jobIndex].end(); predJob++) {
-					int ind = (*predJob)->from->jobIndex;
+				for (int k = node->mAllPreds.begin(jobIndex); k < node->mAllPreds.end(jobIndex); k++) {
+					fixedEdge& predFix = node->allFixes[node->mAllPreds.edges[k]];
+					int ind = predFix.from;
 					if (node->mJobScheduled[ind] == -1) {
 						predDone = false;
 						break;
@@ -598,6 +728,7 @@ int OneMachDPBounds::getUBMod(OneMachDPNode* node)
 // Type 2: LLTH
 int OneMachDPBounds::getUBMod2(OneMachDPNode* node)
 {
+	PROFILE_SCOPE(mOneMachDPData->mProfile, profGetUBMod2);
 	int curTime = 0;
 	int maxTime = 0, temp = 0;
 	int jobSetAvalCount = 0;
@@ -607,6 +738,7 @@ int OneMachDPBounds::getUBMod2(OneMachDPNode* node)
 	JobStep* prev;
 	JobStep* tempStep;
 	list<JobStep*> unschd;
+	vector<JobStep*>& jobs = mOneMachDPData->mJobsByIndex;
 	// availableJobSteps stores job steps that don't have unscheduled predecessor, ordered in ascending by head value
 	minHeadQueue availableJobSteps(stepComp(3));
 	// releaseJobSteps stores job steps that is not only available, but is released, ordered in descending by tail value
@@ -621,7 +753,7 @@ int OneMachDPBounds::getUBMod2(OneMachDPNode* node)
 		step = &*iter;
 		jobIndex = step->jobIndex;
 		step->curHead = step->head;
-		if (node->mAllPreds[jobIndex].empty()) {
+		if (node->mAllPreds.empty(jobIndex)) {
 			availableJobSteps.push(step);
 			jobSetAvalCount++;
 		}
@@ -682,14 +814,14 @@ int OneMachDPBounds::getUBMod2(OneMachDPNode* node)
 		 * 3. Update the release date of successors of the job being scheduled, if necessary.                       *
 		 ************************************************************************************************************/
 		jobIndex = step->jobIndex;
-		for (auto succJob = node->mAllSuccs[jobIndex].begin();
-			succJob != node->mAllSuccs[jobIndex].end(); succJob++) {
-			temp = (*succJob)->delay + curTime;
-			if ((*succJob)->to->curHead < temp) {
-				(*succJob)->to->curHead = temp;
-				updtIndex = (*succJob)->to->jobIndex;
+		for (int k = node->mAllSuccs.begin(jobIndex); k < node->mAllSuccs.end(jobIndex); k++) {
+			fixedEdge& succFix = node->allFixes[node->mAllSuccs.edges[k]];
+			temp = succFix.delay + curTime;
+			if (jobs[succFix.to]->curHead < temp) {
+				jobs[succFix.to]->curHead = temp;
+				updtIndex = succFix.to;
 			}
-			unschd.push_back((*succJob)->to);
+			unschd.push_back(jobs[succFix.to]);
 		}
 		/************************************************************************************************************
 		 * 4. Put the job in existing schedule, keep track of scheduled jobs, and clean up.                         *
@@ -709,9 +841,9 @@ int OneMachDPBounds::getUBMod2(OneMachDPNode* node)
 				jobIndex = step->jobIndex;
 				bool predDone = true;
 				// Check the predecessor list for each unscheduled jobs to see if all predecessor scheduled
-				for (auto predJob = node->mAllPreds[jobIndex].begin();
-					predJob != node->mAllPreds[jobIndex].end(); predJob++) {
-					int ind = (*predJob)->from->jobIndex;
+				for (int k = node->mAllPreds.begin(jobIndex); k < node->mAllPreds.end(jobIndex); k++) {
+					fixedEdge& predFix = node->allFixes[node->mAllPreds.edges[k]];
+					int ind = predFix.from;
 					if (node->mJobScheduled[ind] == -1) {
 						predDone = false;
 						break;
@@ -749,6 +881,7 @@ int OneMachDPBounds::getUBMod3(OneMachDPNode* node)
 	JobStep* prev;
 	JobStep* tempStep;
 	list<JobStep*> unschd;
+	vector<JobStep*>& jobs = mOneMachDPData->mJobsByIndex;
 	// availableJobSteps stores job steps that don't have unscheduled predecessor, ordered in ascending by head value
 	minHeadQueue availableJobSteps(stepComp(3));
 	// releaseJobSteps stores job steps that is not only available, but is released, ordered in descending by tail value
@@ -763,7 +896,7 @@ int OneMachDPBounds::getUBMod3(OneMachDPNode* node)
 		step = &*iter;
 		jobIndex = step->jobIndex;
 		step->curHead = step->head;
-		if (node->mAllPreds[jobIndex].empty()) {
+		if (node->mAllPreds.empty(jobIndex)) {
 			availableJobSteps.push(step);
 			jobSetAvalCount++;
 		}
@@ -828,14 +961,14 @@ int OneMachDPBounds::getUBMod3(OneMachDPNode* node)
 		 * 3. Update the release date of successors of the job being scheduled, if necessary.                       *
 		 ************************************************************************************************************/
 		jobIndex = step->jobIndex;
-		for (auto succJob = node->mAllSuccs[jobIndex].begin();
-			succJob != node->mAllSuccs[jobIndex].end(); succJob++) {
-			temp = (*succJob)->delay + curTime;
-			if ((*succJob)->to->curHead < temp) {
-				(*succJob)->to->curHead = temp;
-				updtIndex = (*succJob)->to->jobIndex;
+		for (int k = node->mAllSuccs.begin(jobIndex); k < node->mAllSuccs.end(jobIndex); k++) {
+			fixedEdge& succFix = node->allFixes[node->mAllSuccs.edges[k]];
+			temp = succFix.delay + curTime;
+			if (jobs[succFix.to]->curHead < temp) {
+				jobs[succFix.to]->curHead = temp;
+				updtIndex = succFix.to;
 			}
-			unschd.push_back((*succJob)->to);
+			unschd.push_back(jobs[succFix.to]);
 		}
 		/************************************************************************************************************
 		 * 4. Put the job in existing schedule, keep track of scheduled jobs, and clean up.                         *
@@ -855,9 +988,9 @@ int OneMachDPBounds::getUBMod3(OneMachDPNode* node)
 				jobIndex = step->jobIndex;
 				bool predDone = true;
 				// Check the predecessor list for each unscheduled jobs to see if all predecessor scheduled
-				for (auto predJob = node->mAllPreds[jobIndex].begin();
-					predJob != node->mAllPreds[jobIndex].end(); predJob++) {
-					int ind = (*predJob)->from->jobIndex;
+				for (int k = node->mAllPreds.begin(jobIndex); k < node->mAllPreds.end(jobIndex); k++) {
+					fixedEdge& predFix = node->allFixes[node->mAllPreds.edges[k]];
+					int ind = predFix.from;
 					if (node->mJobScheduled[ind] == -1) {
 						predDone = false;
 						break;
@@ -7,6 +7,7 @@ void OneMachDPBranch::initialize()
 	mNumRevBrch = 0;
 	mFixMoreCount = 0;
 	mNumNodes = mNumNodesInitLB = 1;
+	mNumLazyBounded = 0;
 	if (mOneMachDPData != nullptr) {
 		mJsonFile = mOneMachDPData->mJsonFile;
 		mRevChkOn = mOneMachDPData->mRevChkOn;
@@ -15,8 +16,9 @@ void OneMachDPBranch::initialize()
 
 int OneMachDPBranch::main(OneMachDPNode* node, int BrchScn) 
 {
+	PROFILE_SCOPE(mOneMachDPData->mProfile, profBranch);
 	mTotalBchCount++;
-	printf("Start branching process...\n");
+	OMDP_LOG(LogDebug, "Start branching process...\n");
 	int revFlag;
 	iterJobs critStep, iter, end;
 	JobStep* specialStep; 
@@ -87,13 +89,22 @@ int OneMachDPBranch::main(OneMachDPNode* node, int BrchScn)
 		curLeft = newOneMachNodeLeft->mNodeID;
 		newOneMachNodeRight->mNodeID = mOneMachDPData->increaseNodeID();
 		curRight = newOneMachNodeRight->mNodeID;
-		//printf("Node %d creates node %d and node %d.\n", node->mNodeID, newOneMachNodeLeft->mNodeID, newOneMachNodeRight->mNodeID);
+		OMDP_LOG(LogTrace, "Node %d creates node %d and node %d.\n", node->mNodeID, newOneMachNodeLeft->mNodeID, newOneMachNodeRight->mNodeID);
 
 		// Update left and right tree level count
 		newOneMachNodeLeft->mLweight++;
 		newOneMachNodeRight->mRweight++;
 		mNumNodes += 2;
 		//node->undoedge();
+		if (mOneMachDPData->mLazyOn) {
+			// Lazy bounding: children are queued with parent's relaxed solution, bounded when selected from
+			// the heads and tails the parent has now, after its post processing. Both share one copy
+			newOneMachNodeLeft->mParentEdge = OneMachDPNode::saveEdge(mOneMachDPData);
+			newOneMachNodeRight->mParentEdge = newOneMachNodeLeft->mParentEdge;
+			mOneMachDPData->addNode(newOneMachNodeLeft);
+			mOneMachDPData->addNode(newOneMachNodeRight);
+			return BrchScn;
+		}
 		// precise lower bound in branching step
 		// Update heads and tails
 		newOneMachNodeLeft->populateFixes();
@@ -120,6 +131,8 @@ int OneMachDPBranch::main(OneMachDPNode* node, int BrchScn)
 		// clean updated info to save space
 		newOneMachNodeLeft->cleanConstrs();
 		newOneMachNodeRight->cleanConstrs();
+		newOneMachNodeLeft->mBounded = true;
+		newOneMachNodeRight->mBounded = true;
 
 		// Store the nodes
 		mOneMachDPData->addNode(newOneMachNodeLeft);
@@ -127,4 +140,26 @@ int OneMachDPBranch::main(OneMachDPNode* node, int BrchScn)
 	}
 	//node->undoedge();
 	return BrchScn;
+}
+
+/************************************************************************************************************
+ * Bound a lazy child when it is selected, from the heads and tails its parent had at branching and its	*
+ * own fixes, as an eager child is. Returns the LB, at least the key the child was queued with				*
+ ************************************************************************************************************/
+int OneMachDPBranch::boundChild(OneMachDPNode* node)
+{
+	int newLB;
+	mNumLazyBounded++;
+	node->doParentEdge();
+	node->populateFixes();
+	node->updateEdge();
+	node->doedge();
+	mOneMachDPData->mComputeBounds->getLBStd(node);
+	newLB = (node->mRexSol > node->mLBound) ? node->mRexSol : node->mLBound;
+	if (newLB == mOneMachDPData->initLB)
+		mNumNodesInitLB++;
+	node->cleanConstrs();
+	node->undoedge();
+	node->mBounded = true;
+	return newLB;
 }
\ No newline at end of file
@@ -0,0 +1,398 @@
+#include "OneMachineDP.h"
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Block tags of the checkpoint file, each block is tag, number of ints, then its ints
+#define CKPT_HEADER 1
+#define CKPT_NODES 2
+#define CKPT_DELETED 3
+#define CKPT_STATE 4
+#define CKPT_INCUMBENT 5
+#define CKPT_REXSOL 6
+#define CKPT_RNG 7
+#define CKPT_END 8
+#define CKPT_MAGIC 0x50444D4F
+// Version 1: journal of tagged blocks, each checkpoint closed by an END block
+// Version 2: restart and memory budget counters in the state, heap keys in node records
+// Version 3: node records end with the parent's heads and tails of a lazy child
+#define CKPT_VERSION 3
+
+void OneMachDPCheckpoint::initialize(const string& path, double interval)
+{
+	mPath = path;
+	mActive = !path.empty();
+	mInterval = (long)(interval * 1000);
+	mLastWrite = 0;
+	mNumWrites = mNumCompacts = 0;
+	mNumRecords = mRecordBytes = mNumBufNodes = 0;
+	mJournalBytes = 0;
+	mPending.clear();
+	mPendingBuf.clear();
+	mDeleted.clear();
+}
+
+/************************************************************************************************************
+ * Counters saved with each checkpoint, in file order. Open node counts are rebuilt from the node records	*
+ ************************************************************************************************************/
+void OneMachDPCheckpoint::stateFields(vector<int*>& fields)
+{
+	OneMachDPData* data = mOneMachDPData;
+	OneMachDPBranch* branch = data->mBranching;
+	fields = { &data->globLB, &data->globUB, &data->initLB, &data->curID, &data->numIter, &data->numNodes,
+		&data->bstFoundAtIter, &data->bstFoundCritSize, &data->numInserted, &data->numBulkPruned, &data->mNumLazyReinsert,
+		&data->maxDepth, &data->mNumLLTH, &data->mNumDives, &data->mNumDiveIter, &data->mNumDropped, &data->mDroppedLB,
+		&branch->mNumStrongBch, &branch->mNumWeakBch1, &branch->mNumWeakBch2, &branch->mNumFeaSolFound, &branch->mNumRevBrch,
+		&branch->mTotalBchCount, &branch->mFixMoreCount, &branch->mNumDiscarded, &branch->mNumNodes, &branch->mNumNodesInitLB,
+		&branch->mNumLazyBounded, &data->mPost->mNumHeadUpdts, &data->mPost->mNumTailUpdts, &data->mPost->mNumRedos,
+		&data->mNumRestarts, &data->mRunBudget, &data->mRunStartIter, &data->mRunStartNodes, &data->mProvenLB,
+		&mContourKey, &mDiveState };
+}
+
+/************************************************************************************************************
+ * Start a new checkpoint file, or restore the search from the existing one. Returns the milliseconds		*
+ * already spent by the restored search																	*
+ ************************************************************************************************************/
+long OneMachDPCheckpoint::start(bool resume)
+{
+	if (resume) {
+		if (!mActive)
+			throw ERROR << "Resume needs a checkpoint file.";
+		return restore();
+	}
+	if (!mActive)
+		return 0;
+	ckptImage image;
+	writeImage(image);
+	return 0;
+}
+
+/************************************************************************************************************
+ * Append the changes since the last checkpoint. Only nodes opened or closed since then are written, so	*
+ * the cost follows the work done between checkpoints and not the size of the open list					*
+ ************************************************************************************************************/
+void OneMachDPCheckpoint::write(long elapsed)
+{
+	OneMachDPData* data = mOneMachDPData;
+	long long numAdded = mNumBufNodes + mPending.size();
+	for (auto iter = mPending.begin(); iter != mPending.end(); iter++) {
+		(*iter)->pack(mPendingBuf);
+		(*iter)->mJournaled = true;
+		(*iter)->mCkptPos = -1;
+	}
+	mPending.clear();
+
+	ckptImage image;
+	fillImage(image, elapsed);
+	FILE* file = fopen(mPath.c_str(), "ab");
+	if (file == nullptr)
+		throw ERROR << "Cannot open checkpoint file " << mPath;
+	writeBlock(file, CKPT_NODES, mPendingBuf.data(), mPendingBuf.size());
+	writeBlock(file, CKPT_DELETED, mDeleted.data(), mDeleted.size());
+	long tailStart = ftell(file);
+	writeTail(file, image);
+	mJournalBytes = ftell(file);
+	long long tailBytes = mJournalBytes - tailStart;
+	fclose(file);
+
+	mNumRecords += numAdded;
+	mRecordBytes += (long long)mPendingBuf.size() * sizeof(int);
+	mPendingBuf.clear();
+	mDeleted.clear();
+	mNumBufNodes = 0;
+	mLastWrite = elapsed;
+	mNumWrites++;
+	// Closed nodes and old states pile up in the journal. A rewrite holds the open nodes at the average
+	// record size and one tail, so it is done once the journal is more than twice that size
+	long long imageBytes = tailBytes + ((mNumRecords > 0) ? data->numToExplore * mRecordBytes / mNumRecords : 0);
+	if (mJournalBytes > 2 * imageBytes + (1 << 16)) {
+		readImage(image);
+		writeImage(image);
+		mNumCompacts++;
+	}
+}
+
+/************************************************************************************************************
+ * Last checkpoint at termination, the open list is dumped after this and must not reach the journal		*
+ ************************************************************************************************************/
+void OneMachDPCheckpoint::close(long elapsed)
+{
+	if (!mActive)
+		return;
+	write(elapsed);
+	mActive = false;
+}
+
+void OneMachDPCheckpoint::nodeAdded(OneMachDPNode* node)
+{
+	if (!mActive)
+		return;
+	node->mCkptPos = mPending.size();
+	mPending.push_back(node);
+}
+
+void OneMachDPCheckpoint::nodeDeleted(OneMachDPNode* node)
+{
+	if (!mActive)
+		return;
+	if (node->mJournaled)
+		mDeleted.push_back(node->mNodeID);
+	else
+		removePending(node);
+}
+
+/************************************************************************************************************
+ * A spilled node leaves memory, so a node not yet journaled is packed now and written at the next			*
+ * checkpoint. Its spill record then marks it journaled													*
+ ************************************************************************************************************/
+void OneMachDPCheckpoint::nodeSpilled(OneMachDPNode* node)
+{
+	if (!mActive || node->mJournaled)
+		return;
+	removePending(node);
+	node->mJournaled = true;
+	node->pack(mPendingBuf);
+	mNumBufNodes++;
+}
+
+void OneMachDPCheckpoint::idDeleted(int nodeID)
+{
+	if (mActive)
+		mDeleted.push_back(nodeID);
+}
+
+void OneMachDPCheckpoint::removePending(OneMachDPNode* node)
+{
+	if (node->mCkptPos < 0)
+		return;
+	mPending[node->mCkptPos] = mPending.back();
+	mPending[node->mCkptPos]->mCkptPos = node->mCkptPos;
+	mPending.pop_back();
+	node->mCkptPos = -1;
+}
+
+/************************************************************************************************************
+ * Restore the open nodes, counters, incumbent and RNG of the last complete checkpoint, then rewrite the	*
+ * file to that state																						*
+ ************************************************************************************************************/
+long OneMachDPCheckpoint::restore()
+{
+	OneMachDPData* data = mOneMachDPData;
+	ckptImage image;
+	readImage(image);
+	vector<int*> fields;
+	stateFields(fields);
+	if (image.state.size() != fields.size() + 1)
+		throw ERROR << "Checkpoint file " << mPath << " holds no complete checkpoint.";
+	long elapsed = image.state[0];
+	for (size_t i = 0; i < fields.size(); i++)
+		*fields[i] = image.state[i + 1];
+
+	data->mBstSolPath.clear();
+	for (auto iter = image.incumbent.begin(); iter != image.incumbent.end(); iter++)
+		data->mBstSolPath.push_back(data->mJobsByIndex[*iter]);
+	for (size_t i = 0; i + 1 < image.rexSolHist.size(); i += 2)
+		data->mRexSolCount.add(image.rexSolHist[i], image.rexSolHist[i + 1]);
+	stringstream rng(image.rng);
+	rng >> data->mRng;
+
+	// Nodes keep their heap keys, and the contour cycle and dive go on where they were, so the resumed
+	// search takes the same path as one that was not interrupted
+	data->mDiving = (mDiveState != -2);
+	data->mDiveNext = nullptr;
+	for (auto iter = image.nodes.begin(); iter != image.nodes.end(); iter++) {
+		int pos = 0;
+		OneMachDPNode* node = OneMachDPNode::unpack(data, iter->second.data(), pos);
+		node->mJournaled = true;
+		data->attachNode(node);
+		data->mLowerBd.add(node->mLBound);
+		data->numToExplore++;
+		if (node->mNodeID == mDiveState)
+			data->mDiveNext = node;
+	}
+	data->mCurContour = data->mContours.find(mContourKey);
+
+	writeImage(image);
+	mLastWrite = elapsed;
+	return elapsed;
+}
+
+void OneMachDPCheckpoint::fillImage(ckptImage& image, long elapsed)
+{
+	OneMachDPData* data = mOneMachDPData;
+	vector<int*> fields;
+	mContourKey = (data->mCurContour != data->mContours.end()) ? data->mCurContour->first : MaxInt;
+	mDiveState = !data->mDiving ? -2 : (data->mDiveNext != nullptr) ? data->mDiveNext->mNodeID : -1;
+	stateFields(fields);
+	image.state.clear();
+	image.state.push_back((int)elapsed);
+	for (auto iter = fields.begin(); iter != fields.end(); iter++)
+		image.state.push_back(**iter);
+	image.incumbent.clear();
+	for (auto iter = data->mBstSolPath.begin(); iter != data->mBstSolPath.end(); iter++)
+		image.incumbent.push_back((*iter)->jobIndex);
+	vector<pair<int, int>> hist;
+	data->mRexSolCount.histogram(hist);
+	image.rexSolHist.clear();
+	for (auto iter = hist.begin(); iter != hist.end(); iter++) {
+		image.rexSolHist.push_back(iter->first);
+		image.rexSolHist.push_back(iter->second);
+	}
+	stringstream rng;
+	rng << data->mRng;
+	image.rng = rng.str();
+}
+
+/************************************************************************************************************
+ * Replay the journal. Changes of a checkpoint take effect at its end block, so a checkpoint cut short by	*
+ * a crash is ignored																						*
+ ************************************************************************************************************/
+void OneMachDPCheckpoint::readImage(ckptImage& image)
+{
+	OneMachDPData* data = mOneMachDPData;
+	FILE* file = fopen(mPath.c_str(), "rb");
+	if (file == nullptr)
+		throw ERROR << "Cannot open checkpoint file " << mPath;
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	vector<int> buf(size / sizeof(int));
+	if (fread(buf.data(), sizeof(int), buf.size(), file) != buf.size()) {
+		fclose(file);
+		throw ERROR << "Cannot read checkpoint file " << mPath;
+	}
+	fclose(file);
+
+	vector<int> fields = { CKPT_MAGIC, CKPT_VERSION, data->numJobs, (int)data->mInitFix.size(), 0 };
+	vector<int*> stateSize;
+	stateFields(stateSize);
+	fields[4] = stateSize.size();
+	if (buf.size() < 2 + fields.size() || buf[0] != CKPT_HEADER || buf[1] != (int)fields.size() || buf[2] != CKPT_MAGIC)
+		throw ERROR << "File " << mPath << " is not a checkpoint file.";
+	if (buf[3] != CKPT_VERSION)
+		throw ERROR << "Checkpoint file " << mPath << " has version " << buf[3] << ", this build reads version " << CKPT_VERSION << ".";
+	if (!equal(fields.begin(), fields.end(), buf.begin() + 2))
+		throw ERROR << "Checkpoint file " << mPath << " does not belong to this instance.";
+
+	ckptImage staged;
+	vector<int> deleted;
+	image.nodes.clear();
+	image.numRecords = 0;
+	int pos = 0;
+	while (pos + 2 <= (int)buf.size() && pos + 2 + buf[pos + 1] <= (int)buf.size()) {
+		int tag = buf[pos], len = buf[pos + 1];
+		const int* payload = buf.data() + pos + 2;
+		pos += 2 + len;
+		switch (tag) {
+		case CKPT_NODES:
+			for (int recPos = 0; recPos < len; ) {
+				int start = recPos;
+				OneMachDPNode::skip(payload + recPos, recPos);
+				staged.nodes[payload[start + 1]].assign(payload + start, payload + recPos);
+			}
+			break;
+		case CKPT_DELETED:
+			deleted.assign(payload, payload + len);
+			break;
+		case CKPT_STATE:
+			staged.state.assign(payload, payload + len);
+			break;
+		case CKPT_INCUMBENT:
+			staged.incumbent.assign(payload, payload + len);
+			break;
+		case CKPT_REXSOL:
+			staged.rexSolHist.assign(payload, payload + len);
+			break;
+		case CKPT_RNG:
+			staged.rng.assign((const char*)(payload + 1), payload[0]);
+			break;
+		case CKPT_END:
+			for (auto iter = staged.nodes.begin(); iter != staged.nodes.end(); iter++)
+				image.nodes[iter->first].swap(iter->second);
+			for (auto iter = deleted.begin(); iter != deleted.end(); iter++)
+				image.nodes.erase(*iter);
+			image.numRecords += staged.nodes.size() + deleted.size();
+			image.state.swap(staged.state);
+			image.incumbent.swap(staged.incumbent);
+			image.rexSolHist.swap(staged.rexSolHist);
+			image.rng.swap(staged.rng);
+			staged.nodes.clear();
+			deleted.clear();
+			break;
+		}
+	}
+}
+
+/************************************************************************************************************
+ * Write image as a fresh file, and replace the old one with it only once it is on disk. rename replaces	*
+ * the file atomically, so a crash leaves either the old or the new checkpoint								*
+ ************************************************************************************************************/
+void OneMachDPCheckpoint::writeImage(const ckptImage& image)
+{
+	OneMachDPData* data = mOneMachDPData;
+	string tmpPath = mPath + ".tmp";
+	FILE* file = fopen(tmpPath.c_str(), "wb");
+	if (file == nullptr)
+		throw ERROR << "Cannot open checkpoint file " << tmpPath;
+	vector<int*> stateSize;
+	stateFields(stateSize);
+	int header[] = { CKPT_MAGIC, CKPT_VERSION, data->numJobs, (int)data->mInitFix.size(), (int)stateSize.size() };
+	writeBlock(file, CKPT_HEADER, header, 5);
+	if (!image.state.empty()) {
+		vector<int> buf;
+		for (auto iter = image.nodes.begin(); iter != image.nodes.end(); iter++)
+			buf.insert(buf.end(), iter->second.begin(), iter->second.end());
+		writeBlock(file, CKPT_NODES, buf.data(), buf.size());
+		writeTail(file, image);
+	}
+	mJournalBytes = ftell(file);
+	int synced = fflush(file);
+#ifdef _WIN32
+	if (synced == 0)
+		synced = _commit(_fileno(file));
+#else
+	if (synced == 0)
+		synced = fsync(fileno(file));
+#endif
+	if (synced != 0) {
+		fclose(file);
+		throw ERROR << "Cannot write checkpoint file " << tmpPath;
+	}
+	fclose(file);
+#ifdef _WIN32
+	// rename of the CRT does not replace an existing file
+	remove(mPath.c_str());
+#endif
+	if (rename(tmpPath.c_str(), mPath.c_str()) != 0)
+		throw ERROR << "Cannot replace checkpoint file " << mPath;
+}
+
+/************************************************************************************************************
+ * Blocks that close one checkpoint: counters, incumbent, histogram, RNG and the end marker				*
+ ************************************************************************************************************/
+void OneMachDPCheckpoint::writeTail(FILE* file, const ckptImage& image)
+{
+	writeBlock(file, CKPT_STATE, image.state.data(), image.state.size());
+	writeBlock(file, CKPT_INCUMBENT, image.incumbent.data(), image.incumbent.size());
+	writeBlock(file, CKPT_REXSOL, image.rexSolHist.data(), image.rexSolHist.size());
+	vector<int> rng(1 + (image.rng.size() + sizeof(int) - 1) / sizeof(int), 0);
+	rng[0] = image.rng.size();
+	memcpy(rng.data() + 1, image.rng.data(), image.rng.size());
+	writeBlock(file, CKPT_RNG, rng.data(), rng.size());
+	writeBlock(file, CKPT_END, nullptr, 0);
+	if (ferror(file) || fflush(file) != 0) {
+		fclose(file);
+		throw ERROR << "Cannot write checkpoint file " << mPath;
+	}
+}
+
+void OneMachDPCheckpoint::writeBlock(FILE* file, int tag, const int* data, int size)
+{
+	int head[] = { tag, size };
+	fwrite(head, sizeof(int), 2, file);
+	if (size > 0)
+		fwrite(data, sizeof(int), size, file);
+}
@@ -12,6 +12,7 @@ void OneMachDPCritPath::initialize()
 
 void OneMachDPCritPath::main(OneMachDPNode* node) 
 {
+	PROFILE_SCOPE(mOneMachDPData->mProfile, profCritPath);
 	mCurNode = node;
 	mCurFeaSol = mCurNode->mFeaSol;
 	mLgstPathesByJob.resize(mOneMachDPData->numJobs);
@@ -84,14 +85,15 @@ int OneMachDPCritPath::findAllLgestPathToJob(JobStep* curJob)
 	maxLgthIndices.push_back(prevIndex);
 	
 	// If predecessor exists, check DPCs
-	if (!mCurNode->mAllPreds[curIndex].empty()) {
-		auto iter = mCurNode->mAllPreds[curIndex].begin();
-		auto end = mCurNode->mAllPreds[curIndex].end();
+	if (!mCurNode->mAllPreds.empty(curIndex)) {
+		int k = mCurNode->mAllPreds.begin(curIndex);
+		int end = mCurNode->mAllPreds.end(curIndex);
 		JobStep* predStep;
-		while (iter != end) {
+		while (k != end) {
+			fixedEdge& predFix = mCurNode->allFixes[mCurNode->mAllPreds.edges[k]];
 			// Only DPCs matter
-			if ((*iter)->delay != 0) {
-				predStep = (*iter)->from;
+			if (predFix.delay != 0) {
+				predStep = mIndexedJob[predFix.from];
 				curPathLgth = findAllLgestPathToJob(predStep);
 				curPathLgth += (predStep->body + mOneMachDPData->getDelay(predStep->jobIndex, curIndex));
 				if (curPathLgth > maxPathLgth) {
@@ -100,7 +102,7 @@ int OneMachDPCritPath::findAllLgestPathToJob(JobStep* curJob)
 				}
 				int predStepIndex = predStep->jobIndex;
 				if (predStepIndex == prevIndex) {
-					iter++;
+					k++;
 					continue;
 				}
 				//if (curPathLgth >= maxPathLgth && mCanBeInCritPath[predStepIndex] == 0)
@@ -110,7 +112,7 @@ int OneMachDPCritPath::findAllLgestPathToJob(JobStep* curJob)
 			} else {
 				break;
 			}
-			iter++;
+			k++;
 		}
 	}
 	// Last, check current head
@@ -218,18 +220,14 @@ void OneMachDPCritPath::findValidCritPath()
 		// If there is a gap before the first job of critical path
 		if (mMaxLgthToJob[curIndex] - mMaxLgthToJob[preStep->jobIndex] - preStep->body > 0) {
 			bool byDPC = false;
-			auto iter = mCurNode->mAllPreds[curIndex].begin();
-			auto end = mCurNode->mAllPreds[curIndex].end();
-			while (iter != end) {
-				if ((*iter)->delay == 0) {
-					iter++;
+			for (int k = mCurNode->mAllPreds.begin(curIndex); k < mCurNode->mAllPreds.end(curIndex); k++) {
+				fixedEdge& predFix = mCurNode->allFixes[mCurNode->mAllPreds.edges[k]];
+				if (predFix.delay == 0)
 					continue;
-				}
-				if (mMaxLgthToJob[curIndex] - mMaxLgthToJob[(*iter)->from->jobIndex] - (*iter)->delay == 0) {
+				if (mMaxLgthToJob[curIndex] - mMaxLgthToJob[predFix.from] - predFix.delay == 0) {
 					byDPC = true;
 					break;
 				}
-				iter++;
 			}
 			if (byDPC) {
 				mAllCritPath.erase(pathIter);
@@ -0,0 +1,51 @@
+#include "OneMachineDP.h"
+
+/************************************************************************************************************
+ * Build all invariants of the instance from the initial precedence arcs									*
+ ************************************************************************************************************/
+OneMachDPIndex::OneMachDPIndex(OneMachDPData* omdp)
+{
+	mNumJobs = omdp->numJobs;
+	mInitPreds.build(omdp->mInitFix, mNumJobs, false);
+	mInitSuccs.build(omdp->mInitFix, mNumJobs, true);
+
+	// DPC lists keep one arc per job pair, with the delay used by the delay matrix
+	vector<pair<int, int>> dpcPairs;
+	for (auto iter = omdp->mInitFix.begin(); iter != omdp->mInitFix.end(); iter++) {
+		if (omdp->getDelay((*iter).from, (*iter).to) != 0)
+			dpcPairs.push_back(pair<int, int>((*iter).from, (*iter).to));
+	}
+	sort(dpcPairs.begin(), dpcPairs.end());
+	dpcPairs.erase(unique(dpcPairs.begin(), dpcPairs.end()), dpcPairs.end());
+	for (auto iter = dpcPairs.begin(); iter != dpcPairs.end(); iter++)
+		mDPCFix.push_back(fixedEdge((*iter).first, (*iter).second, omdp->getDelay((*iter).first, (*iter).second)));
+	mDPCSuccs.build(mDPCFix, mNumJobs, true);
+
+	checkAcyclic(omdp->mInitFix);
+}
+
+/************************************************************************************************************
+ * Kahn's algorithm on initial arcs, a cycle means the instance has no feasible schedule					*
+ ************************************************************************************************************/
+void OneMachDPIndex::checkAcyclic(const edgeList& fixes)
+{
+	int job, next;
+	vector<int> numPreds(mNumJobs, 0);
+	vector<int> order;
+	order.reserve(mNumJobs);
+	for (job = 0; job < mNumJobs; job++) {
+		numPreds[job] = mInitPreds.size(job);
+		if (numPreds[job] == 0)
+			order.push_back(job);
+	}
+	for (size_t pos = 0; pos < order.size(); pos++) {
+		job = order[pos];
+		for (int k = mInitSuccs.begin(job); k < mInitSuccs.end(job); k++) {
+			next = fixes[mInitSuccs.edges[k]].to;
+			if (--numPreds[next] == 0)
+				order.push_back(next);
+		}
+	}
+	if ((int)order.size() < mNumJobs)
+		throw ERROR << "Initial precedence arcs contain a cycle.";
+}
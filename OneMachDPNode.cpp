@@ -3,9 +3,13 @@
 OneMachDPNode::OneMachDPNode(OneMachDPData* oneMachDP) 
 {
 	isInMap = true;
+	mBounded = true;
+	mJournaled = false;
+	mHeapPos = mLBPos = mCkptPos = -1;
+	mTieKey = 0;
+	mHeapSeq = -1;
 	mOneMachDPData = oneMachDP;
 	allFixes = oneMachDP->mInitFix;
-	auto end = oneMachDP->mInitFix.end();
 	mNodeID = mOneMachDPData->curID;
 	mLBound = 0;
 	mRexSol = 0;
@@ -18,6 +22,11 @@ OneMachDPNode::OneMachDPNode(OneMachDPData* oneMachDP)
 OneMachDPNode::OneMachDPNode(OneMachDPNode* parent) 
 {
 	isInMap = true;
+	mBounded = false;
+	mJournaled = false;
+	mHeapPos = mLBPos = mCkptPos = -1;
+	mTieKey = 0;
+	mHeapSeq = -1;
 	mOneMachDPData = parent->mOneMachDPData;
 	allFixes = parent->allFixes;
 	mParentID = parent->mNodeID;
@@ -44,28 +53,109 @@ OneMachDPNode::OneMachDPNode(OneMachDPNode* org, bool inMap)
 	mRexSol = org->mRexSol;
 	mParentSol = org->mParentSol;
 	mDepth = org->mDepth;
-	// Initialize precedence vectors
-	mAllPreds.resize(org->mOneMachDPData->numJobs);
-	mAllSuccs.resize(org->mOneMachDPData->numJobs);
 	// Reverse each precedence constraints
-	auto iter = org->allFixes.begin();
-	auto end = org->allFixes.end();
-	while (iter != end) {
-		addFix((*iter).to, (*iter).from, (*iter).delay);
-		iter++;
-	}
+	allFixes.reserve(org->allFixes.size());
+	for (auto iter = org->allFixes.begin(); iter != org->allFixes.end(); iter++)
+		allFixes.push_back(fixedEdge((*iter).to, (*iter).from, (*iter).delay));
+	// Reversed fixes do not start with the initial arcs, so build from scratch
+	mAllPreds.build(allFixes, mOneMachDPData->numJobs, false, fixAdjacency::Spare);
+	mAllSuccs.build(allFixes, mOneMachDPData->numJobs, true, fixAdjacency::Spare);
 }
 
+/************************************************************************************************************
+ * allFixes always starts with the initial arcs, only fixes added in the search are placed here			*
+ ************************************************************************************************************/
 void OneMachDPNode::populateFixes() 
 {
-	mAllPreds.clear();
-	mAllSuccs.clear();
-	mAllPreds.resize(mOneMachDPData->numJobs);
-	mAllSuccs.resize(mOneMachDPData->numJobs);
-	for (auto iter = allFixes.begin(); iter != allFixes.end(); iter++) {
-		mAllPreds[(*iter).to->jobIndex].push_back(&*iter);
-		mAllSuccs[(*iter).from->jobIndex].push_back(&*iter);
+	const OneMachDPIndex* index = mOneMachDPData->mIndex;
+	mAllPreds.build(index->mInitPreds, allFixes, mOneMachDPData->numJobs, false, fixAdjacency::Spare);
+	mAllSuccs.build(index->mInitSuccs, allFixes, mOneMachDPData->numJobs, true, fixAdjacency::Spare);
+}
+
+/************************************************************************************************************
+ * Build adjacency from fixes in one counting pass, keeping the order of fixes for each job, with spare	*
+ * slots at the end of each row																				*
+ ************************************************************************************************************/
+void fixAdjacency::build(const edgeList& fixes, int numJobs, bool bySucc, int spare)
+{
+	int job;
+	count.assign(numJobs, 0);
+	for (auto iter = fixes.begin(); iter != fixes.end(); iter++)
+		count[bySucc ? (*iter).from : (*iter).to]++;
+	start.resize(numJobs + 1);
+	start[0] = 0;
+	for (job = 0; job < numJobs; job++)
+		start[job + 1] = start[job] + count[job] + spare;
+	edges.resize(start[numJobs]);
+	vector<int> pos(start.begin(), start.end() - 1);
+	for (size_t i = 0; i < fixes.size(); i++) {
+		job = bySucc ? fixes[i].from : fixes[i].to;
+		edges[pos[job]++] = (int)i;
+	}
+}
+
+/************************************************************************************************************
+ * Build adjacency of fixes whose first entries are the arcs of init, copying init instead of recounting	*
+ ************************************************************************************************************/
+void fixAdjacency::build(const fixAdjacency& init, const edgeList& fixes, int numJobs, bool bySucc, int spare)
+{
+	int job;
+	size_t numInit = 0;
+	count.resize(numJobs);
+	for (job = 0; job < numJobs; job++) {
+		count[job] = init.size(job);
+		numInit += init.size(job);
+	}
+	for (size_t i = numInit; i < fixes.size(); i++)
+		count[bySucc ? fixes[i].from : fixes[i].to]++;
+	start.resize(numJobs + 1);
+	start[0] = 0;
+	for (job = 0; job < numJobs; job++)
+		start[job + 1] = start[job] + count[job] + spare;
+	edges.resize(start[numJobs]);
+	vector<int> pos(numJobs);
+	for (job = 0; job < numJobs; job++) {
+		copy(init.edges.begin() + init.begin(job), init.edges.begin() + init.end(job), edges.begin() + start[job]);
+		pos[job] = start[job] + init.size(job);
 	}
+	for (size_t i = numInit; i < fixes.size(); i++) {
+		job = bySucc ? fixes[i].from : fixes[i].to;
+		edges[pos[job]++] = (int)i;
+	}
+}
+
+void fixAdjacency::reset(int numJobs)
+{
+	count.assign(numJobs, 0);
+	start.resize(numJobs + 1);
+	for (int job = 0; job <= numJobs; job++)
+		start[job] = job * Spare;
+	edges.resize(numJobs * Spare);
+}
+
+/************************************************************************************************************
+ * Add edge as the last edge of job, in a spare slot of its row												*
+ ************************************************************************************************************/
+void fixAdjacency::insert(int job, int edge)
+{
+	if (start[job] + count[job] == start[job + 1])
+		grow(job);
+	edges[start[job] + count[job]++] = edge;
+}
+
+/************************************************************************************************************
+ * Double the slots of a full row. Every row after it moves, so one call costs time linear in all edges;	*
+ * doubling keeps the calls for a row logarithmic in its edges												*
+ ************************************************************************************************************/
+void fixAdjacency::grow(int job)
+{
+	int numJobs = (int)count.size();
+	int extra = (count[job] > Spare) ? count[job] : Spare;
+	edges.resize(edges.size() + extra);
+	for (int k = start[numJobs] - 1; k >= start[job + 1]; k--)
+		edges[k + extra] = edges[k];
+	for (int i = job + 1; i <= numJobs; i++)
+		start[i] += extra;
 }
 
 /************************************************************************************************************
@@ -80,6 +170,34 @@ void OneMachDPNode::doedge()
 	}
 }
 
+/************************************************************************************************************
+ * Current heads and tails of all jobsteps, to be shared by the children of the node in process				*
+ ************************************************************************************************************/
+shared_ptr<const edgeSnapshot> OneMachDPNode::saveEdge(OneMachDPData* omdp)
+{
+	shared_ptr<edgeSnapshot> snapshot = make_shared<edgeSnapshot>();
+	snapshot->head.resize(omdp->numJobs);
+	snapshot->tail.resize(omdp->numJobs);
+	for (auto iter = omdp->mJobsData.begin(); iter != omdp->mJobsData.end(); iter++) {
+		snapshot->head[(*iter).jobIndex] = (*iter).head;
+		snapshot->tail[(*iter).jobIndex] = (*iter).tail;
+	}
+	return snapshot;
+}
+
+/************************************************************************************************************
+ * Change heads and tails of all jobsteps to those of the parent, and let go of the parent's copy			*
+ ************************************************************************************************************/
+void OneMachDPNode::doParentEdge()
+{
+	auto end = mOneMachDPData->mJobsData.end();
+	for (auto iter = mOneMachDPData->mJobsData.begin(); iter != end; iter++) {
+		(*iter).head = mParentEdge->head[(*iter).jobIndex];
+		(*iter).tail = mParentEdge->tail[(*iter).jobIndex];
+	}
+	mParentEdge.reset();
+}
+
 /************************************************************************************************************
  * Recover heads and tails of all jobsteps																	*
  ************************************************************************************************************/
@@ -127,7 +245,7 @@ int OneMachDPNode::fixMore(int curBstSol)
 		}
 		iter++;
 	}
-	//printf("%d additional edges are fixed. %d is the gap.\n", fixmoreCount, gap);
+	OMDP_LOG(LogTrace, "%d additional edges are fixed. %d is the gap.\n", fixmoreCount, gap);
 	return fixmoreCount;
 }
 
@@ -136,6 +254,7 @@ int OneMachDPNode::fixMore(int curBstSol)
  ************************************************************************************************************/
 void OneMachDPNode::updateEdge() 
 {
+	PROFILE_SCOPE(mOneMachDPData->mProfile, profUpdateEdge);
 	int numJobs = mOneMachDPData->numJobs;
 	mUpdatedHead.clear();
 	mUpdatedHead.resize(numJobs, -1);
@@ -146,13 +265,54 @@ void OneMachDPNode::updateEdge()
 	while (iter != end) {
 		JobStep* curIter = &*iter;
 		int curInd = curIter->jobIndex;
-		//printf("Current job index is %d.\n", curInd);
+		OMDP_LOG(LogTrace, "Current job index is %d.\n", curInd);
 		updateHeadHelper(curInd);
 		updateTailHelper(curInd);
 		iter++;
 	}
 }
 
+/************************************************************************************************************
+ * Incremental update of heads and tails after post processing. Only heads of headJobs and their			*
+ * successors, and tails of tailJobs and their predecessors are recomputed, the rest are kept				*
+ ************************************************************************************************************/
+void OneMachDPNode::updateEdge(vector<int> &headJobs, vector<int> &tailJobs)
+{
+	PROFILE_SCOPE(mOneMachDPData->mProfile, profUpdateEdge);
+	vector<int> toUpdate;
+	vector<int> jobStack;
+	int curInd;
+	// Invalidate heads of headJobs and every job that can be reached from them
+	jobStack = headJobs;
+	while (!jobStack.empty()) {
+		curInd = jobStack.back();
+		jobStack.pop_back();
+		if (mUpdatedHead[curInd] == -1)
+			continue;
+		mUpdatedHead[curInd] = -1;
+		toUpdate.push_back(curInd);
+		for (int k = mAllSuccs.begin(curInd); k < mAllSuccs.end(curInd); k++)
+			jobStack.push_back(allFixes[mAllSuccs.edges[k]].to);
+	}
+	for (int jobIndex : toUpdate)
+		updateHeadHelper(jobIndex);
+	toUpdate.clear();
+	// Invalidate tails of tailJobs and every job that can reach them
+	jobStack = tailJobs;
+	while (!jobStack.empty()) {
+		curInd = jobStack.back();
+		jobStack.pop_back();
+		if (mUpdatedTail[curInd] == -1)
+			continue;
+		mUpdatedTail[curInd] = -1;
+		toUpdate.push_back(curInd);
+		for (int k = mAllPreds.begin(curInd); k < mAllPreds.end(curInd); k++)
+			jobStack.push_back(allFixes[mAllPreds.edges[k]].from);
+	}
+	for (int jobIndex : toUpdate)
+		updateTailHelper(jobIndex);
+}
+
 /************************************************************************************************************
  * Recursively update all head of jobsteps that have predesessors											*
  ************************************************************************************************************/
@@ -160,24 +320,21 @@ int OneMachDPNode::updateHeadHelper(int jobIndex)
 {
 	if (mUpdatedHead[jobIndex] != -1) {
 		// if not -1, then head already updated, nothing needs to be done
-	} else if (mAllPreds.empty() || mAllPreds[jobIndex].empty()) {
-		mUpdatedHead[jobIndex] = mOneMachDPData->getJobStep(jobIndex)->head;
+	} else if (mAllPreds.start.empty() || mAllPreds.empty(jobIndex)) {
+		mUpdatedHead[jobIndex] = mOneMachDPData->mJobsByIndex[jobIndex]->head;
 	} else {
 		multimap<int, int> smallHead;
-		int sumTime = 0, maxHead = mOneMachDPData->getJobStep(jobIndex)->head;
+		int sumTime = 0, maxHead = mOneMachDPData->mJobsByIndex[jobIndex]->head;
 		int head, body, delay, temp;
-		auto iter = mAllPreds[jobIndex].begin();
-		auto end = mAllPreds[jobIndex].end();
-		while (iter != end) {
-			JobStep* curIter = (*iter)->from;
-			head = updateHeadHelper(curIter->jobIndex);
-			body = curIter->body;
-			delay = (*iter)->delay;
+		for (int k = mAllPreds.begin(jobIndex); k < mAllPreds.end(jobIndex); k++) {
+			fixedEdge& predFix = allFixes[mAllPreds.edges[k]];
+			head = updateHeadHelper(predFix.from);
+			body = mOneMachDPData->mJobsByIndex[predFix.from]->body;
+			delay = predFix.delay;
 			temp = head + body + delay;
 			maxHead = (temp > maxHead) ? temp : maxHead;
 			smallHead.insert(pair<int, int>(head, body));
 			sumTime += body;
-			iter++;
 		}
 		for (auto iter = smallHead.begin(); iter != smallHead.end(); iter++) {
 			temp = (*iter).first + sumTime;
@@ -186,7 +343,7 @@ int OneMachDPNode::updateHeadHelper(int jobIndex)
 		}
 		mUpdatedHead[jobIndex] = maxHead;
 	}
-	//printf("Job %d has head %d.\n", jobIndex, mHeadUpdated[jobIndex]);
+	OMDP_LOG(LogTrace, "Job %d has head %d.\n", jobIndex, mUpdatedHead[jobIndex]);
 	return mUpdatedHead[jobIndex];
 }
 
@@ -195,28 +352,25 @@ int OneMachDPNode::updateHeadHelper(int jobIndex)
  ************************************************************************************************************/
 int OneMachDPNode::updateTailHelper(int jobIndex) 
 {
-	JobStep* curJobStep = mOneMachDPData->getJobStep(jobIndex);
+	JobStep* curJobStep = mOneMachDPData->mJobsByIndex[jobIndex];
 	if (mUpdatedTail[jobIndex] != -1) {
 		// if not -1, then tail already updated, nothing needs to be done
-	} else if (mAllSuccs.empty() || mAllSuccs[jobIndex].empty()) {
+	} else if (mAllSuccs.start.empty() || mAllSuccs.empty(jobIndex)) {
 		mUpdatedTail[jobIndex] = curJobStep->tail;
 	} else {
 		multimap<int, int> smallTail;
 		int sumTime = 0, maxTail = curJobStep->tail;
 		int tail, body, delay, temp;
 		int newMethodTail = 0;
-		auto iter = mAllSuccs[jobIndex].begin();
-		auto end = mAllSuccs[jobIndex].end();
-		while (iter != end) {
-			JobStep* curIter = (*iter)->to;
-			tail = updateTailHelper(curIter->jobIndex);
-			body = curIter->body;
-			delay = (*iter)->delay;
+		for (int k = mAllSuccs.begin(jobIndex); k < mAllSuccs.end(jobIndex); k++) {
+			fixedEdge& succFix = allFixes[mAllSuccs.edges[k]];
+			tail = updateTailHelper(succFix.to);
+			body = mOneMachDPData->mJobsByIndex[succFix.to]->body;
+			delay = succFix.delay;
 			temp = tail + delay + body;
 			maxTail = (temp > maxTail) ? temp : maxTail;
 			smallTail.insert(pair<int, int>(tail, body));
 			sumTime += body;
-			iter++;
 		}
 		for (auto iter = smallTail.begin(); iter != smallTail.end(); iter++) {
 			temp = (*iter).first + sumTime;
@@ -226,22 +380,22 @@ int OneMachDPNode::updateTailHelper(int jobIndex)
 		/***************Experiment Procedure*******************/
 		newMethodTail = updateTailBySucc(jobIndex);
 		if (newMethodTail > maxTail)
-			printf("New tail is larger.");
+			OMDP_LOG(LogDebug, "New tail is larger.\n");
 		maxTail = (newMethodTail > maxTail) ? newMethodTail : maxTail;
 		/******************************************************/
 		if (curJobStep->isTailUpdated && curJobStep->tail < maxTail)
 			maxTail = curJobStep->tail;
 		mUpdatedTail[jobIndex] = maxTail;
 	}
-	//printf("Job %d has tail %d.\n", jobIndex, mTailUpdated[jobIndex]);
+	OMDP_LOG(LogTrace, "Job %d has tail %d.\n", jobIndex, mUpdatedTail[jobIndex]);
 	return mUpdatedTail[jobIndex];
 }
 
 int OneMachDPNode::updateTailBySucc(int jobIndex)
 {
-	if (mAllSuccs[jobIndex].front()->delay == 0)
+	if (allFixes[mAllSuccs.edges[mAllSuccs.begin(jobIndex)]].delay == 0)
 		return 0;		// if no DPC, no need for the procedure
-	if (mAllSuccs[jobIndex].size() < 2) 
+	if (mAllSuccs.size(jobIndex) < 2) 
 		return 0;		// if only one or less successor, no need for the procedure
 
 	int bound;
@@ -256,40 +410,40 @@ int OneMachDPNode::updateTailBySucc(int jobIndex)
 
 	OneMachDPNode* tempNode = new OneMachDPNode();
 	tempNode->mOneMachDPData = mOneMachDPData;
-	tempNode->mAllPreds.resize(mOneMachDPData->numJobs);
-	tempNode->mAllSuccs.resize(mOneMachDPData->numJobs);
-
-	auto iter = mAllSuccs[jobIndex].begin();
-	auto end = mAllSuccs[jobIndex].end();
-	curStep = (*iter)->from;
-	while (iter != end) {
-		jobsToSchdByInd[(*iter)->to->jobIndex] = 1;
-		jobsToSchd.push_back((*iter)->to);
-		orgJobHeads[(*iter)->to->jobIndex] = (*iter)->to->head;		// record head info
-		orgJobTails[(*iter)->to->jobIndex] = (*iter)->to->tail;		// record tail info
-		(*iter)->to->head = (*iter)->delay;							// set head based on delay
-		(*iter)->to->tail = mUpdatedTail[(*iter)->to->jobIndex];	// set tail based on updated tail
-		for (auto i = mAllSuccs[(*iter)->to->jobIndex].begin(); i != mAllSuccs[(*iter)->to->jobIndex].end(); i++) {
-			if (jobsToSchdByInd[(*i)->to->jobIndex] == 1)
-				tempNode->addFixNoChk((*iter)->to, (*i)->to, 0);	// delay info not useful in preemptive version, set to 0
+	tempNode->mAllPreds.reset(mOneMachDPData->numJobs);
+	tempNode->mAllSuccs.reset(mOneMachDPData->numJobs);
+
+	vector<JobStep*>& jobs = mOneMachDPData->mJobsByIndex;
+	curStep = jobs[jobIndex];
+	for (int k = mAllSuccs.begin(jobIndex); k < mAllSuccs.end(jobIndex); k++) {
+		fixedEdge& succFix = allFixes[mAllSuccs.edges[k]];
+		JobStep* succStep = jobs[succFix.to];
+		jobsToSchdByInd[succFix.to] = 1;
+		jobsToSchd.push_back(succStep);
+		orgJobHeads[succFix.to] = succStep->head;		// record head info
+		orgJobTails[succFix.to] = succStep->tail;		// record tail info
+		succStep->head = succFix.delay;					// set head based on delay
+		succStep->tail = mUpdatedTail[succFix.to];		// set tail based on updated tail
+		for (int l = mAllSuccs.begin(succFix.to); l < mAllSuccs.end(succFix.to); l++) {
+			int nextIndex = allFixes[mAllSuccs.edges[l]].to;
+			if (jobsToSchdByInd[nextIndex] == 1)
+				tempNode->addFixNoChk(succStep, jobs[nextIndex], 0);	// delay info not useful in preemptive version, set to 0
 		}
-		iter++;
 	}
 	bound = mOneMachDPData->mComputeBounds->getLBStd(tempNode, jobsToSchd);
 	delete tempNode;
 	// recover heads and tails of all jobs involved
-	iter = mAllSuccs[jobIndex].begin();
-	while (iter != end) {
-		(*iter)->to->head = orgJobHeads[(*iter)->to->jobIndex];
-		(*iter)->to->tail = orgJobTails[(*iter)->to->jobIndex];
-		iter++;
+	for (int k = mAllSuccs.begin(jobIndex); k < mAllSuccs.end(jobIndex); k++) {
+		int succIndex = allFixes[mAllSuccs.edges[k]].to;
+		jobs[succIndex]->head = orgJobHeads[succIndex];
+		jobs[succIndex]->tail = orgJobTails[succIndex];
 	}
 	return bound;
 }
 
 bool OneMachDPNode::havePrecConstrBasic(int fromIndex, int toIndex) {
 	for (auto iter = allFixes.begin(); iter != allFixes.end(); iter++) {
-		if ((*iter).from->jobIndex == fromIndex && (*iter).to->jobIndex == toIndex)
+		if ((*iter).from == fromIndex && (*iter).to == toIndex)
 			return true;
 	}
 	return false;
@@ -301,15 +455,16 @@ bool OneMachDPNode::havePrecConstrBasic(int fromIndex, int toIndex) {
 bool OneMachDPNode::havePrecConstr(int fromIndex, int toIndex, int remGap) 
 {
 	if (fromIndex == toIndex) return false;
-	if (mAllSuccs[fromIndex].empty()) return false;
-	for (auto iter = mAllSuccs[fromIndex].begin(); iter != mAllSuccs[fromIndex].end(); iter++) {
-		if (((*iter)->to)->jobIndex == toIndex)
+	if (mAllSuccs.empty(fromIndex)) return false;
+	for (int k = mAllSuccs.begin(fromIndex); k < mAllSuccs.end(fromIndex); k++) {
+		if (allFixes[mAllSuccs.edges[k]].to == toIndex)
 			return true;
 	}
 	if (remGap > 0) {
 		remGap--;
-		for (auto iter = mAllSuccs[fromIndex].begin(); iter != mAllSuccs[fromIndex].end(); iter++) {
-			if (havePrecConstr((*iter)->to->jobIndex, toIndex, remGap)) {
+		// a recursive call only adds a fix when it returns true, so the range stays valid while searching
+		for (int k = mAllSuccs.begin(fromIndex); k < mAllSuccs.end(fromIndex); k++) {
+			if (havePrecConstr(allFixes[mAllSuccs.edges[k]].to, toIndex, remGap)) {
 				addFixNoChk(mOneMachDPData->mJobsByIndex[fromIndex], mOneMachDPData->mJobsByIndex[toIndex], 0);
 				return true;
 			}
@@ -351,6 +506,7 @@ int OneMachDPNode::numJobsBtwn(int fromIndex, int toIndex)
 
 int OneMachDPNode::branchingScenario() 
 {				
+	PROFILE_SCOPE(mOneMachDPData->mProfile, profBrchScn);
 	int sumPath;									// The sum of body and delay on the testing path (excluding first head and last tail)
 	int minNumPrec = MaxInt;						// Set the min number of precedence arcs in a path to number of fixes (large number)
 	int maxStpAftCrit = 0;
@@ -440,7 +596,7 @@ int OneMachDPNode::branchingScenario()
 			for (; tempIter != mCritPath.end(); tempIter++) {
 				gap = numJobsBtwn(mLastPrecStep->jobIndex, (*tempIter)->jobIndex);
 				if ((*tempIter)->head < curBest && !havePrecConstr(mLastPrecStep->jobIndex, (*tempIter)->jobIndex, gap)) {
-					//printf("Current step: %d, with head %d.\n", (*tempIter)->jobIndex, (*tempIter)->head);
+					OMDP_LOG(LogTrace, "Current step: %d, with head %d.\n", (*tempIter)->jobIndex, (*tempIter)->head);
 					curBest = (*tempIter)->head;
 					mSpecialStep = *tempIter;
 				}
@@ -543,9 +699,10 @@ void OneMachDPNode::updateHeadInSol()
 	iter = mSolPath.begin();
 	while (iter != end) {
 		curIndex = (*iter)->jobIndex;
-		for (auto i = mAllSuccs[curIndex].begin(); i != mAllSuccs[curIndex].end(); i++) {
-			temp = mJobScheduled[curIndex] + (*iter)->body + (*i)->delay;
-			mLongestToCur[(*i)->to->jobIndex] = (mLongestToCur[(*i)->to->jobIndex] < temp) ? temp : mLongestToCur[(*i)->to->jobIndex];
+		for (int k = mAllSuccs.begin(curIndex); k < mAllSuccs.end(curIndex); k++) {
+			fixedEdge& succFix = allFixes[mAllSuccs.edges[k]];
+			temp = mJobScheduled[curIndex] + (*iter)->body + succFix.delay;
+			mLongestToCur[succFix.to] = (mLongestToCur[succFix.to] < temp) ? temp : mLongestToCur[succFix.to];
 		}
 		iter++;
 	}
@@ -632,19 +789,16 @@ void OneMachDPNode::addFix(JobStep* from, JobStep* to, int delay)
 		return;
 	// Only add if the edge is not previously present
 	if (!havePrecConstr(from->jobIndex, to->jobIndex, 0)) {
-		allFixes.push_back(fixedEdge(from, to, delay));
-		fixedEdge* temp = &(allFixes.back());
-		mAllPreds[to->jobIndex].push_back(temp);
-		mAllSuccs[from->jobIndex].push_back(temp);
+		addFixNoChk(from, to, delay);
 	}
 }
 
 void OneMachDPNode::addFixNoChk(JobStep* from, JobStep* to, int delay) 
 {
-	allFixes.push_back(fixedEdge(from, to, delay));
-	fixedEdge* temp = &(allFixes.back());
-	mAllPreds[to->jobIndex].push_back(temp);
-	mAllSuccs[from->jobIndex].push_back(temp);
+	allFixes.push_back(fixedEdge(from->jobIndex, to->jobIndex, delay));
+	int edgeIndex = (int)allFixes.size() - 1;
+	mAllPreds.insert(to->jobIndex, edgeIndex);
+	mAllSuccs.insert(from->jobIndex, edgeIndex);
 }
 
 /************************************************************************************************************
@@ -655,9 +809,12 @@ void OneMachDPNode::addFixBasic(JobStep* from, JobStep* to, int delay)
 	if (from->jobIndex == to->jobIndex)
 		return;
 	if (!havePrecConstrBasic(from->jobIndex, to->jobIndex))
-		allFixes.push_back(fixedEdge(from, to, delay));
+		allFixes.push_back(fixedEdge(from->jobIndex, to->jobIndex, delay));
 }
 
+/************************************************************************************************************
+ * Drop the working state of a bounded node. The adjacency is released, with its spare slots				*
+ ************************************************************************************************************/
 void OneMachDPNode::cleanConstrs() 
 {
 	mAllPreds.clear();
@@ -666,6 +823,108 @@ void OneMachDPNode::cleanConstrs()
 	mUpdatedTail.clear();
 }
 
+/************************************************************************************************************
+ * Estimate of the bytes held by the node, its object and the storage of its containers, by category		*
+ ************************************************************************************************************/
+long long OneMachDPNode::memBytes(int* bytes)
+{
+	bytes[memNodeObj] = sizeof(OneMachDPNode);
+	bytes[memFixes] = allFixes.capacity() * sizeof(fixedEdge);
+	bytes[memAdjacency] = (mAllPreds.start.capacity() + mAllPreds.count.capacity() + mAllPreds.edges.capacity()
+		+ mAllSuccs.start.capacity() + mAllSuccs.count.capacity() + mAllSuccs.edges.capacity()) * sizeof(int);
+	bytes[memSchedule] = (mUpdatedHead.capacity() + mUpdatedTail.capacity() + mJobScheduled.capacity() + mLongestToCur.capacity()
+		+ mIndInPathByPos.capacity() + mPosInPathByJob.capacity()) * sizeof(int);
+	// The parent's heads and tails are counted in equal shares by the children holding them
+	if (mParentEdge)
+		bytes[memSchedule] += (sizeof(edgeSnapshot) + (mParentEdge->head.capacity() + mParentEdge->tail.capacity()) * sizeof(int))
+			/ mParentEdge.use_count();
+	// list nodes hold the pointer and two links
+	bytes[memPaths] = (mCritPath.size() + mSolPath.size() + mLBSolPath.size()) * 3 * sizeof(void*);
+	return (long long)bytes[memNodeObj] + bytes[memFixes] + bytes[memAdjacency] + bytes[memSchedule] + bytes[memPaths];
+}
+
+// Ints of a node record before its fixes: numFix, nodeID, parentID, LB, rexSol, feaSol, parentSol, depth,
+// lweight, rweight, bounded, journaled, tieKey, heapSeq, numEdge
+#define NODE_RECORD_HEADER 15
+
+/************************************************************************************************************
+ * Record of an open node for spill and checkpoint files: its scalar fields, the fixes added after the		*
+ * initial arcs, and the parent's heads and tails a lazy child is bounded from. The contour is not stored,	*
+ * it is recomputed when the node is put back into the open list. The heap key is, so the node takes its	*
+ * old place among ties																						*
+ ************************************************************************************************************/
+void OneMachDPNode::pack(vector<int>& buf)
+{
+	int numInit = mOneMachDPData->mInitFix.size();
+	buf.push_back(allFixes.size() - numInit);
+	buf.push_back(mNodeID);
+	buf.push_back(mParentID);
+	buf.push_back(mLBound);
+	buf.push_back(mRexSol);
+	buf.push_back(mFeaSol);
+	buf.push_back(mParentSol);
+	buf.push_back(mDepth);
+	buf.push_back(mLweight);
+	buf.push_back(mRweight);
+	buf.push_back(mBounded ? 1 : 0);
+	buf.push_back(mJournaled ? 1 : 0);
+	buf.push_back(mTieKey);
+	buf.push_back(mHeapSeq);
+	buf.push_back(mParentEdge ? (int)mParentEdge->head.size() : 0);
+	for (size_t i = numInit; i < allFixes.size(); i++) {
+		buf.push_back(allFixes[i].from);
+		buf.push_back(allFixes[i].to);
+		buf.push_back(allFixes[i].delay);
+	}
+	if (mParentEdge) {
+		buf.insert(buf.end(), mParentEdge->head.begin(), mParentEdge->head.end());
+		buf.insert(buf.end(), mParentEdge->tail.begin(), mParentEdge->tail.end());
+	}
+}
+
+/************************************************************************************************************
+ * Build a node from a record made by pack, and advance pos past the record									*
+ ************************************************************************************************************/
+OneMachDPNode* OneMachDPNode::unpack(OneMachDPData* omdp, const int* rec, int& pos)
+{
+	const int header = NODE_RECORD_HEADER;
+	OneMachDPNode* node = new OneMachDPNode();
+	node->mOneMachDPData = omdp;
+	node->mNodeID = rec[1];
+	node->mParentID = rec[2];
+	node->mLBound = rec[3];
+	node->mRexSol = rec[4];
+	node->mFeaSol = rec[5];
+	node->mParentSol = rec[6];
+	node->mDepth = rec[7];
+	node->mLweight = rec[8];
+	node->mRweight = rec[9];
+	node->mBounded = (rec[10] == 1);
+	node->mJournaled = (rec[11] == 1);
+	node->mTieKey = rec[12];
+	node->mHeapSeq = rec[13];
+	node->mHeapPos = node->mLBPos = node->mCkptPos = -1;
+	node->isInMap = true;
+	node->allFixes.reserve(omdp->mInitFix.size() + rec[0]);
+	node->allFixes.assign(omdp->mInitFix.begin(), omdp->mInitFix.end());
+	for (int i = 0; i < rec[0]; i++)
+		node->allFixes.push_back(fixedEdge(rec[header + 3 * i], rec[header + 3 * i + 1], rec[header + 3 * i + 2]));
+	if (rec[14] > 0) {
+		const int* edge = rec + header + 3 * rec[0];
+		shared_ptr<edgeSnapshot> snapshot = make_shared<edgeSnapshot>();
+		snapshot->head.assign(edge, edge + rec[14]);
+		snapshot->tail.assign(edge + rec[14], edge + 2 * rec[14]);
+		node->mParentEdge = snapshot;
+	}
+	pos += header + 3 * rec[0] + 2 * rec[14];
+	return node;
+}
+
+void OneMachDPNode::skip(const int* rec, int& pos)
+{
+	pos += NODE_RECORD_HEADER + 3 * rec[0] + 2 * rec[14];
+}
+
 void OneMachDPNode::clearAll() 
 {
 	cleanConstrs();
@@ -700,13 +959,14 @@ OneMachDPNode* OneMachDPNode::revNode()
 	rev->mUpdatedHead = mUpdatedTail;
 	rev->mUpdatedTail = mUpdatedHead;
 	// Initialize precedence vectors
-	rev->mAllPreds.resize(mOneMachDPData->numJobs);
-	rev->mAllSuccs.resize(mOneMachDPData->numJobs);
+	rev->mAllPreds.reset(mOneMachDPData->numJobs);
+	rev->mAllSuccs.reset(mOneMachDPData->numJobs);
 	// Reverse each precedence constraints
+	vector<JobStep*>& jobs = mOneMachDPData->mJobsByIndex;
 	auto iter = allFixes.begin();
 	auto end = allFixes.end();
 	while (iter != end) {
-		rev->addFix((*iter).to, (*iter).from, (*iter).delay);
+		rev->addFix(jobs[(*iter).to], jobs[(*iter).from], (*iter).delay);
 		iter++;
 	}
 	return rev;
@@ -0,0 +1,96 @@
+#include "OneMachineDP.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+/************************************************************************************************************
+ * Open one group of user space counters for the calling thread, led by the cycle counter. An event that	*
+ * cannot be opened is left out of the group; without the leader nothing is counted and only times are		*
+ * collected																								*
+ ************************************************************************************************************/
+void OneMachDPProfile::openCounters()
+{
+	if (!mHwRequested || mHwActive)
+		return;
+	mNumHwOpen = 0;
+	for (int e = 0; e < NumHwEvents; e++) {
+		mHwSlot[e] = -1;
+		mHwFds[e] = -1;
+	}
+#ifdef __linux__
+	static const unsigned int types[NumHwEvents] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE };
+	static const unsigned long long configs[NumHwEvents] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), PERF_COUNT_HW_BRANCH_MISSES };
+	for (int e = 0; e < NumHwEvents; e++) {
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = types[e];
+		attr.config = configs[e];
+		attr.disabled = (e == hwCycles) ? 1 : 0;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		int fd = syscall(__NR_perf_event_open, &attr, 0, -1, (e == hwCycles) ? -1 : mHwFds[hwCycles], 0);
+		if (fd < 0) {
+			if (e == hwCycles) {
+				OMDP_LOG(LogWarn, "Hardware counters are not available, profiling times only.\n");
+				return;
+			}
+			continue;
+		}
+		mHwFds[e] = fd;
+		mHwSlot[e] = mNumHwOpen++;
+	}
+	ioctl(mHwFds[hwCycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(mHwFds[hwCycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	mHwActive = true;
+#else
+	OMDP_LOG(LogWarn, "Hardware counters are only supported on Linux, profiling times only.\n");
+#endif
+}
+
+/************************************************************************************************************
+ * Current value of each event, with one read of the group. Events not counted read as 0					*
+ ************************************************************************************************************/
+void OneMachDPProfile::readCounters(long long* values)
+{
+	for (int e = 0; e < NumHwEvents; e++)
+		values[e] = 0;
+#ifdef __linux__
+	// nr, time enabled, time running, then the value of each event in the order they were opened
+	unsigned long long buf[3 + NumHwEvents];
+	if (read(mHwFds[hwCycles], buf, sizeof(buf)) < (ssize_t)(3 * sizeof(unsigned long long)))
+		return;
+	mHwEnabled = buf[1];
+	mHwRunning = buf[2];
+	for (int e = 0; e < NumHwEvents; e++) {
+		if (mHwSlot[e] >= 0)
+			values[e] = buf[3 + mHwSlot[e]];
+	}
+#endif
+}
+
+void OneMachDPProfile::closeCounters()
+{
+	if (!mHwActive)
+		return;
+#ifdef __linux__
+	for (int e = 0; e < NumHwEvents; e++) {
+		if (mHwFds[e] >= 0)
+			close(mHwFds[e]);
+		mHwFds[e] = -1;
+	}
+#endif
+	mHwActive = false;
+}
+
+const char* OneMachDPProfile::hwName(int event)
+{
+	static const char* names[NumHwEvents] = { "cycles", "instructions", "LLCMisses", "branchMisses" };
+	return names[event];
+}
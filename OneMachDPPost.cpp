@@ -5,7 +5,7 @@ void OneMachDPPost::initialize()
 	if (mOneMachDPData != nullptr) {
 		mJsonFile = mOneMachDPData->mJsonFile;
 	}
-	mNumHeadUpdts = mNumTailUpdts = 0;
+	mNumHeadUpdts = mNumTailUpdts = mNumRedos = 0;
 }
 
 /************************************************************************************************************
@@ -13,6 +13,7 @@ void OneMachDPPost::initialize()
  ************************************************************************************************************/
 bool OneMachDPPost::main(OneMachDPNode* node)
 {
+	PROFILE_SCOPE(mOneMachDPData->mProfile, profPost);
 	if (mOneMachDPData->numInitFix == 0)
 		return false;
 	bool headChanged = false, tailChanged = false;
@@ -20,7 +21,9 @@ bool OneMachDPPost::main(OneMachDPNode* node)
 	list<list<JobStep*>>::iterator pathIter;
 	list<list<JobStep*>>::iterator pathEnd;
 
-	printf("Start post processing...\n");
+	mNewPredJobs.clear();
+	mTailUpdtJobs.clear();
+	OMDP_LOG(LogDebug, "Start post processing...\n");
 
 	pathIter = mOneMachDPData->mCritPathes->mAllCritPath.begin();
 	pathEnd = mOneMachDPData->mCritPathes->mAllCritPath.end();
@@ -37,6 +40,7 @@ bool OneMachDPPost::main(OneMachDPNode* node)
 		pathIter++;
 	}
 	if (hasTailUpdates) {
+		mNumRedos++;
 		return hasTailUpdates;
 	} else {
 		pathIter = mOneMachDPData->mCritPathes->mAllCritPath.begin();
@@ -90,6 +94,7 @@ bool OneMachDPPost::chkPrecedPost(OneMachDPNode* node)
 			jobToErase--;
 			while ((*jobToErase)->jobIndex != preIndex) {
 				node->addFix(iterJob, *jobToErase, 0);
+				mNewPredJobs.push_back((*jobToErase)->jobIndex);
 				mCurPath->erase(jobToErase);
 				// Erase moves the iterator forward, need to counter this with --
 				jobToErase = mCurPath->end();
@@ -97,13 +102,14 @@ bool OneMachDPPost::chkPrecedPost(OneMachDPNode* node)
 			}
 			mCurPath->erase(jobToErase);
 			mCurJobErased = true;
+			mTailUpdtJobs.push_back(curIndex);
 
 			newTail = node->mFeaSol - node->mJobScheduled[curIndex] - iterJob->body;
 			if (node->mUpdatedTail[curIndex] != newTail) {
 				node->mUpdatedTail[curIndex] = newTail;
-				mOneMachDPData->getJobStep(curIndex)->tail = newTail;
-				mOneMachDPData->getJobStep(curIndex)->isTailUpdated = true;
-				//printf("Job step %d has updated tail %d.\n", curIndex, newTail);
+				mOneMachDPData->mJobsByIndex[curIndex]->tail = newTail;
+				mOneMachDPData->mJobsByIndex[curIndex]->isTailUpdated = true;
+				OMDP_LOG(LogTrace, "Job step %d has updated tail %d.\n", curIndex, newTail);
 				mNumTailUpdts++;
 				return true;
 			} else {
@@ -169,8 +175,8 @@ bool OneMachDPPost::chkSuccedPost(OneMachDPNode* node)
 			mCurJobErased = true;
 			if (node->mUpdatedHead[curIndex] != newHead) {
 				node->mUpdatedHead[curIndex] = newHead;
-				mOneMachDPData->getJobStep(curIndex)->head = newHead;
-				//printf("Job step %d has updated head %d.\n", curIndex, newHead);
+				mOneMachDPData->mJobsByIndex[curIndex]->head = newHead;
+				OMDP_LOG(LogTrace, "Job step %d has updated head %d.\n", curIndex, newHead);
 				mNumHeadUpdts++;
 				return true;
 			} else {
@@ -0,0 +1,95 @@
+#include "OneMachineDP.h"
+
+/************************************************************************************************************
+ * Start the reporter thread when an interval is given														*
+ ************************************************************************************************************/
+void OneMachDPProgress::initialize(double interval, const string& path)
+{
+	mInterval = interval;
+	mPath = path;
+	mActive = interval > 0;
+	mNumReports = 0;
+	mDone = false;
+	mIter = mNodes = mOpen = mGlobLB = mContour = 0;
+	mGlobUB = MaxInt;
+	mElapsed = 0;
+	mOpenBytes = 0;
+	if (mActive)
+		mWorker = thread(&OneMachDPProgress::run, this);
+}
+
+/************************************************************************************************************
+ * Called by the search between iterations. The counters are read one by one, so a report may mix two		*
+ * consecutive iterations																					*
+ ************************************************************************************************************/
+void OneMachDPProgress::publish()
+{
+	OneMachDPData* data = mOneMachDPData;
+	mIter.store(data->numIter, memory_order_relaxed);
+	mNodes.store(data->numNodes, memory_order_relaxed);
+	mOpen.store(data->numToExplore, memory_order_relaxed);
+	mGlobLB.store(data->globLB, memory_order_relaxed);
+	mGlobUB.store(data->globUB, memory_order_relaxed);
+	mContour.store((data->mCurContour != data->mContours.end()) ? data->mCurContour->first : -1, memory_order_relaxed);
+	mElapsed.store(data->mElapsTime, memory_order_relaxed);
+	mOpenBytes.store(data->mOpenBytes, memory_order_relaxed);
+}
+
+/************************************************************************************************************
+ * Stop the reporter thread																					*
+ ************************************************************************************************************/
+void OneMachDPProgress::finish()
+{
+	if (!mActive)
+		return;
+	{
+		lock_guard<mutex> guard(mLock);
+		mDone = true;
+	}
+	mWake.notify_one();
+	mWorker.join();
+	mActive = false;
+}
+
+void OneMachDPProgress::run()
+{
+	FILE* file = stdout;
+	if (!mPath.empty() && (file = fopen(mPath.c_str(), "w")) == nullptr) {
+		OMDP_LOG(LogWarn, "Cannot open progress file %s.\n", mPath.c_str());
+		file = stdout;
+	}
+	myclock::time_point last = myclock::now(), now;
+	int lastNodes = mNodes.load(memory_order_relaxed), nodes;
+	chrono::duration<double> interval(mInterval);
+	unique_lock<mutex> guard(mLock);
+	while (!mWake.wait_for(guard, interval, [this]() { return mDone; })) {
+		now = myclock::now();
+		nodes = mNodes.load(memory_order_relaxed);
+		report(file, (nodes - lastNodes) / chrono::duration<double>(now - last).count());
+		last = now;
+		lastNodes = nodes;
+	}
+	if (file != stdout)
+		fclose(file);
+}
+
+/************************************************************************************************************
+ * A line of text on stdout, or one JSON object per line to the progress file								*
+ ************************************************************************************************************/
+void OneMachDPProgress::report(FILE* file, double rate)
+{
+	int LB = mGlobLB.load(memory_order_relaxed), UB = mGlobUB.load(memory_order_relaxed);
+	double gap = (UB > 0 && UB < MaxInt) ? (double)(UB - LB) / UB : 1;
+	mNumReports++;
+	if (file == stdout) {
+		printf("Progress at %.1fs: iter %d, nodes %d, %.0f nodes/s, open %d, LB %d, UB %d, gap %.4f, open bytes %lld, contour %d.\n",
+			mElapsed.load(memory_order_relaxed) / 1000.0, mIter.load(memory_order_relaxed), mNodes.load(memory_order_relaxed), rate,
+			mOpen.load(memory_order_relaxed), LB, UB, gap, mOpenBytes.load(memory_order_relaxed), mContour.load(memory_order_relaxed));
+	} else {
+		fprintf(file, "{\"elapsedMs\": %ld, \"iter\": %d, \"nodes\": %d, \"nodesPerSec\": %.1f, \"open\": %d, \"globLB\": %d, \"globUB\": %d, "
+			"\"gap\": %.6f, \"openBytes\": %lld, \"contour\": %d}\n", mElapsed.load(memory_order_relaxed), mIter.load(memory_order_relaxed),
+			mNodes.load(memory_order_relaxed), rate, mOpen.load(memory_order_relaxed), LB, UB, gap, mOpenBytes.load(memory_order_relaxed),
+			mContour.load(memory_order_relaxed));
+	}
+	fflush(file);
+}
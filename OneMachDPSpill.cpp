@@ -0,0 +1,217 @@
+#include "OneMachineDP.h"
+
+void OneMachDPSpill::initialize()
+{
+	mNumRuns = mNumSpilled = mNumLoaded = mNumReadAhead = 0;
+	cancelReadAhead();
+	mRuns.clear();
+}
+
+/************************************************************************************************************
+ * Move open nodes of the largest LBs to one run file, until open nodes in memory take half of the limit.	*
+ * The nodes stay counted in mLowerBd and numToExplore, so the global LB remains valid						*
+ ************************************************************************************************************/
+void OneMachDPSpill::spill()
+{
+	OneMachDPData* data = mOneMachDPData;
+	long long target = data->mSpillBytes / 2;
+	vector<OneMachDPNode*> nodes;
+	while (data->mOpenBytes > target && !data->mOpenByLB.empty()) {
+		OneMachDPNode* node = data->mOpenByLB.rbegin()->second.back();
+		data->detachNode(node);
+		nodes.push_back(node);
+	}
+	if (nodes.empty())
+		return;
+
+	// Nodes were taken from the largest LB down, write them in ascending LB
+	spillRun run;
+	vector<int> buf;
+	char name[64];
+	snprintf(name, sizeof(name), "/omdp_%p_%s_%d.run", (void*)data, data->mIsRev ? "rev" : "fwd", mNumRuns++);
+	run.path = data->mSpillDir + name;
+	for (auto iter = nodes.rbegin(); iter != nodes.rend(); iter++) {
+		OneMachDPNode* node = *iter;
+		data->mCheckpoint->nodeSpilled(node);
+		run.nodeIDs.push_back(node->mNodeID);
+		if (run.lbCounts.empty() || run.lbCounts.back().first != node->mLBound) {
+			run.lbCounts.push_back(pair<int, int>(node->mLBound, 0));
+			run.offsets.push_back((long)(buf.size() * sizeof(int)));
+		}
+		node->pack(buf);
+		run.lbCounts.back().second++;
+		run.numNodes++;
+		// Not in the open list any more, so deletion must not touch it
+		node->isInMap = false;
+		delete node;
+	}
+	run.offsets.push_back((long)(buf.size() * sizeof(int)));
+
+	FILE* file = fopen(run.path.c_str(), "wb");
+	if (file == nullptr)
+		throw ERROR << "Cannot open spill file " << run.path;
+	if (fwrite(buf.data(), sizeof(int), buf.size(), file) != buf.size()) {
+		fclose(file);
+		throw ERROR << "Cannot write spill file " << run.path;
+	}
+	fclose(file);
+	mNumSpilled += run.numNodes;
+	mRuns.insert(pair<int, spillRun>(run.lbCounts.front().first, run));
+}
+
+/************************************************************************************************************
+ * Page nodes back in while the smallest LB on disk is below the smallest LB in memory. Nodes of an equal	*
+ * LB wait until memory has none of that LB left, otherwise a spill of the smallest LB in memory is read	*
+ * back at once and the two thrash. The run due next is then read ahead									*
+ ************************************************************************************************************/
+void OneMachDPSpill::loadDue()
+{
+	OneMachDPData* data = mOneMachDPData;
+	while (!mRuns.empty()) {
+		int memLB = data->mOpenByLB.empty() ? MaxInt : data->mOpenByLB.begin()->first;
+		if (mRuns.begin()->first >= memLB)
+			break;
+		loadRun(mRuns.begin(), memLB);
+	}
+	readAhead();
+}
+
+/************************************************************************************************************
+ * Start reading the first LB of the run with the smallest LB on a background thread, so the search does	*
+ * not wait for the disk when that LB comes up. A read ahead of another run is given up					*
+ ************************************************************************************************************/
+void OneMachDPSpill::readAhead()
+{
+	if (mRuns.empty())
+		return;
+	spillRun& next = mRuns.begin()->second;
+	if (mAheadPath == next.path && mAheadBegin == next.offsets.front())
+		return;
+	cancelReadAhead();
+	mAheadPath = next.path;
+	mAheadBegin = next.offsets.front();
+	mAhead = async(launch::async, readPart, next.path, next.offsets[0], next.offsets[1]);
+}
+
+void OneMachDPSpill::cancelReadAhead()
+{
+	// Errors of a read that is not used are raised again by the read that replaces it
+	if (mAhead.valid())
+		mAhead.wait();
+	mAhead = future<vector<int>>();
+	mAheadPath.clear();
+}
+
+/************************************************************************************************************
+ * Bytes begin to end of a run file. Runs on the read ahead thread, and touches no search state			*
+ ************************************************************************************************************/
+vector<int> OneMachDPSpill::readPart(string path, long begin, long end)
+{
+	vector<int> buf((end - begin) / sizeof(int));
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr)
+		throw ERROR << "Cannot open spill file " << path;
+	if (fseek(file, begin, SEEK_SET) != 0 || fread(buf.data(), sizeof(int), buf.size(), file) != buf.size()) {
+		fclose(file);
+		throw ERROR << "Cannot read spill file " << path;
+	}
+	fclose(file);
+	return buf;
+}
+
+/************************************************************************************************************
+ * Drop whole runs that can not improve on globUB, without reading them									*
+ ************************************************************************************************************/
+void OneMachDPSpill::pruneRuns()
+{
+	OneMachDPData* data = mOneMachDPData;
+	while (!mRuns.empty() && mRuns.rbegin()->first >= data->globUB) {
+		data->numBulkPruned += mRuns.rbegin()->second.numNodes;
+		dropRun(prev(mRuns.end()));
+	}
+}
+
+void OneMachDPSpill::dropAll()
+{
+	while (!mRuns.empty())
+		dropRun(mRuns.begin());
+}
+
+/************************************************************************************************************
+ * Read the prefix of a run whose LBs are below memLB, one LB at a time, and rebuild its nodes into the	*
+ * open list. The first LB is always read, from the read ahead when it is of this run, the next ones only	*
+ * while memory stays under half the limit. The rest of the run stays on disk, keyed by its new smallest LB	*
+ ************************************************************************************************************/
+void OneMachDPSpill::loadRun(multimap<int, spillRun>::iterator run, int memLB)
+{
+	OneMachDPData* data = mOneMachDPData;
+	spillRun& part = run->second;
+	FILE* file = nullptr;
+	vector<int> buf;
+	size_t numLB = 0, numNodes = 0;
+	bool ahead = (mAheadPath == part.path && mAheadBegin == part.offsets.front());
+	do {
+		if (ahead) {
+			buf = mAhead.get();
+			mAheadPath.clear();
+			mNumReadAhead++;
+			ahead = false;
+		} else {
+			if (file == nullptr) {
+				file = fopen(part.path.c_str(), "rb");
+				if (file == nullptr)
+					throw ERROR << "Cannot open spill file " << part.path;
+				if (fseek(file, part.offsets[numLB], SEEK_SET) != 0) {
+					fclose(file);
+					throw ERROR << "Cannot read spill file " << part.path;
+				}
+			}
+			buf.resize((part.offsets[numLB + 1] - part.offsets[numLB]) / sizeof(int));
+			if (fread(buf.data(), sizeof(int), buf.size(), file) != buf.size()) {
+				fclose(file);
+				throw ERROR << "Cannot read spill file " << part.path;
+			}
+		}
+		int pos = 0;
+		while (pos < (int)buf.size()) {
+			OneMachDPNode* node = OneMachDPNode::unpack(data, &buf[pos], pos);
+			data->attachNode(node);
+			mNumLoaded++;
+		}
+		numNodes += part.lbCounts[numLB++].second;
+	} while (numLB < part.lbCounts.size() && part.lbCounts[numLB].first < memLB && data->mOpenBytes < data->mSpillBytes / 2);
+	if (file != nullptr)
+		fclose(file);
+
+	if (numLB == part.lbCounts.size()) {
+		remove(part.path.c_str());
+		mRuns.erase(run);
+		return;
+	}
+	spillRun rest;
+	rest.path = part.path;
+	rest.numNodes = part.numNodes - (int)numNodes;
+	rest.lbCounts.assign(part.lbCounts.begin() + numLB, part.lbCounts.end());
+	rest.offsets.assign(part.offsets.begin() + numLB, part.offsets.end());
+	rest.nodeIDs.assign(part.nodeIDs.begin() + numNodes, part.nodeIDs.end());
+	mRuns.erase(run);
+	mRuns.insert(pair<int, spillRun>(rest.lbCounts.front().first, rest));
+}
+
+void OneMachDPSpill::dropRun(multimap<int, spillRun>::iterator run)
+{
+	OneMachDPData* data = mOneMachDPData;
+	if (mAheadPath == run->second.path)
+		cancelReadAhead();
+	for (auto iter = run->second.lbCounts.begin(); iter != run->second.lbCounts.end(); iter++) {
+		for (int i = 0; i < iter->second; i++) {
+			if (!data->mLowerBd.remove(iter->first))
+				throw ERROR << "Cannot locate search item.";
+		}
+	}
+	data->numToExplore -= run->second.numNodes;
+	for (auto iter = run->second.nodeIDs.begin(); iter != run->second.nodeIDs.end(); iter++)
+		data->mCheckpoint->idDeleted(*iter);
+	remove(run->second.path.c_str());
+	mRuns.erase(run);
+}
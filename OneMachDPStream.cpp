@@ -0,0 +1,91 @@
+#include "OneMachineDP.h"
+
+/************************************************************************************************************
+ * Start the stream thread when a file or callback is given. The file is opened by the thread, since		*
+ * opening a pipe waits for its reader																		*
+ ************************************************************************************************************/
+void OneMachDPStream::initialize(const string& path, incumbentCallback callback)
+{
+	mPath = path;
+	mCallback = callback;
+	mActive = !path.empty() || callback != nullptr;
+	mNumPosted = 0;
+	mDone = false;
+	mQueue.clear();
+	if (mActive)
+		mWorker = thread(&OneMachDPStream::run, this);
+}
+
+/************************************************************************************************************
+ * Queue event for the stream thread, the search only waits for the queue lock							*
+ ************************************************************************************************************/
+void OneMachDPStream::post(incumbentEvent& event)
+{
+	if (!mActive)
+		return;
+	{
+		lock_guard<mutex> guard(mLock);
+		mQueue.push_back(incumbentEvent());
+		mQueue.back().makespan = event.makespan;
+		mQueue.back().iter = event.iter;
+		mQueue.back().elapsed = event.elapsed;
+		mQueue.back().order.swap(event.order);
+	}
+	mNumPosted++;
+	mReady.notify_one();
+}
+
+/************************************************************************************************************
+ * Deliver the queued events and stop the stream thread														*
+ ************************************************************************************************************/
+void OneMachDPStream::finish()
+{
+	if (!mActive)
+		return;
+	{
+		lock_guard<mutex> guard(mLock);
+		mDone = true;
+	}
+	mReady.notify_one();
+	mWorker.join();
+	mActive = false;
+}
+
+void OneMachDPStream::run()
+{
+	FILE* file = nullptr;
+	if (!mPath.empty()) {
+		file = fopen(mPath.c_str(), "w");
+		if (file == nullptr)
+			OMDP_LOG(LogWarn, "Cannot open incumbent stream %s.\n", mPath.c_str());
+	}
+	incumbentEvent event;
+	while (true) {
+		{
+			unique_lock<mutex> guard(mLock);
+			mReady.wait(guard, [this]() { return mDone || !mQueue.empty(); });
+			if (mQueue.empty())
+				break;
+			event = mQueue.front();
+			mQueue.pop_front();
+		}
+		if (file != nullptr)
+			write(file, event);
+		if (mCallback != nullptr)
+			mCallback(event);
+	}
+	if (file != nullptr)
+		fclose(file);
+}
+
+/************************************************************************************************************
+ * One JSON object per line, flushed so that a reader of a pipe sees it at once								*
+ ************************************************************************************************************/
+void OneMachDPStream::write(FILE* file, const incumbentEvent& event)
+{
+	fprintf(file, "{\"makespan\": %d, \"iter\": %d, \"elapsedMs\": %ld, \"order\": [", event.makespan, event.iter, event.elapsed);
+	for (size_t i = 0; i < event.order.size(); i++)
+		fprintf(file, "%s%d", (i == 0) ? "" : ", ", event.order[i]);
+	fprintf(file, "]}\n");
+	fflush(file);
+}
@@ -0,0 +1,84 @@
+#include "OneMachineDP.h"
+
+/************************************************************************************************************
+ * Open the timeline file. Times are microseconds from here on, all events are on one thread				*
+ ************************************************************************************************************/
+void OneMachDPTimeline::initialize(const string& path, int every)
+{
+	mActive = false;
+	mSampled = false;
+	mNumEvents = 0;
+	mEvery = (every > 0) ? every : 1;
+	mFile = nullptr;
+	if (path.empty())
+		return;
+	if ((mFile = fopen(path.c_str(), "w")) == nullptr) {
+		OMDP_LOG(LogWarn, "Cannot open timeline file %s.\n", path.c_str());
+		return;
+	}
+	fprintf(mFile, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+	fprintf(mFile, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"search %s\"}}",
+		mOneMachDPData->mOneMachineName.c_str());
+	mOrigin = myclock::now();
+	mActive = true;
+}
+
+/************************************************************************************************************
+ * Start of solveNode on the node of iteration iter, which is sampled when iter is a multiple of k			*
+ ************************************************************************************************************/
+void OneMachDPTimeline::beginNode(int iter)
+{
+	mSampled = (iter % mEvery == 0);
+	mNodeIter = iter;
+	if (mSampled)
+		mNodeStart = myclock::now();
+}
+
+/************************************************************************************************************
+ * The solveNode span of a sampled node. It is written after the spans of its phases, which the viewer	*
+ * nests by time																							*
+ ************************************************************************************************************/
+void OneMachDPTimeline::endNode(OneMachDPNode* node, int flag)
+{
+	if (!mSampled)
+		return;
+	myclock::time_point end = myclock::now();
+	fprintf(mFile, ",\n{\"name\": \"solveNode\", \"cat\": \"node\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": 1, "
+		"\"args\": {\"iter\": %d, \"nodeID\": %d, \"flag\": %d, \"LB\": %d, \"rexSol\": %d, \"feaSol\": %d, \"depth\": %d}}",
+		micros(mNodeStart), micros(end) - micros(mNodeStart), mNodeIter, node->mNodeID, flag, node->mLBound, node->mRexSol,
+		(flag < 4) ? node->mFeaSol : -1, node->mDepth);
+	mNumEvents++;
+	mSampled = false;
+}
+
+void OneMachDPTimeline::span(const char* name, myclock::time_point start, myclock::time_point end)
+{
+	event(name, "phase", start, end);
+}
+
+void OneMachDPTimeline::incumbent(int makespan, int iter)
+{
+	fprintf(mFile, ",\n{\"name\": \"incumbent\", \"cat\": \"incumbent\", \"ph\": \"i\", \"s\": \"g\", \"ts\": %.3f, \"pid\": 1, \"tid\": 1, "
+		"\"args\": {\"makespan\": %d, \"iter\": %d}}", micros(myclock::now()), makespan, iter);
+	mNumEvents++;
+}
+
+void OneMachDPTimeline::event(const char* name, const char* cat, myclock::time_point start, myclock::time_point end)
+{
+	fprintf(mFile, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": 1}", name, cat,
+		micros(start), micros(end) - micros(start));
+	mNumEvents++;
+}
+
+/************************************************************************************************************
+ * Close the event list, the file is valid JSON only after this												*
+ ************************************************************************************************************/
+void OneMachDPTimeline::finish()
+{
+	if (!mActive)
+		return;
+	fprintf(mFile, "\n]}\n");
+	fclose(mFile);
+	mActive = false;
+	mSampled = false;
+}
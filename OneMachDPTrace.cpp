@@ -0,0 +1,105 @@
+#include "OneMachineDP.h"
+
+/************************************************************************************************************
+ * Start the writer thread when a trace file is given														*
+ ************************************************************************************************************/
+void OneMachDPTrace::initialize(const string& path)
+{
+	mPath = path;
+	mActive = !path.empty();
+	mNumStalls = 0;
+	mHead = 0;
+	mTail = 0;
+	mDone = false;
+	if (mActive) {
+		mRing.resize(Capacity);
+		mWorker = thread(&OneMachDPTrace::run, this);
+	}
+}
+
+/************************************************************************************************************
+ * Copy rec into the ring. Only this thread moves mHead and only the writer moves mTail, so no lock is		*
+ * taken unless the ring is full																			*
+ ************************************************************************************************************/
+void OneMachDPTrace::record(const traceRecord& rec)
+{
+	if (!mActive)
+		return;
+	long long head = mHead.load(memory_order_relaxed);
+	if (head - mTail.load(memory_order_acquire) == Capacity) {
+		unique_lock<mutex> guard(mLock);
+		mNumStalls++;
+		mReady.notify_one();
+		mSpace.wait(guard, [this, head]() { return head - mTail.load(memory_order_acquire) < Capacity; });
+	}
+	mRing[head & (Capacity - 1)] = rec;
+	mHead.store(head + 1, memory_order_release);
+	if (((head + 1) & (FlushBatch - 1)) == 0)
+		mReady.notify_one();
+}
+
+/************************************************************************************************************
+ * Write the remaining records and stop the writer thread													*
+ ************************************************************************************************************/
+void OneMachDPTrace::finish()
+{
+	if (!mActive)
+		return;
+	{
+		lock_guard<mutex> guard(mLock);
+		mDone = true;
+	}
+	mReady.notify_one();
+	mWorker.join();
+	mActive = false;
+}
+
+/************************************************************************************************************
+ * Drain the ring whenever a batch is pending, or every 100 ms so that a slow search still reaches the		*
+ * file. A wake up missed by record is caught by the timeout												*
+ ************************************************************************************************************/
+void OneMachDPTrace::run()
+{
+	FILE* file = fopen(mPath.c_str(), "wb");
+	if (file == nullptr)
+		OMDP_LOG(LogWarn, "Cannot open trace file %s.\n", mPath.c_str());
+	else {
+		int header[] = { TRACE_MAGIC, TRACE_VERSION, (int)sizeof(traceRecord), mOneMachDPData->numJobs };
+		fwrite(header, sizeof(int), 4, file);
+	}
+	long long tail = 0, head;
+	bool done;
+	while (true) {
+		// mDone is read before mHead, so once it is seen the last record is seen too
+		done = mDone;
+		head = mHead.load(memory_order_acquire);
+		if (head - tail < FlushBatch && !done) {
+			unique_lock<mutex> guard(mLock);
+			mReady.wait_for(guard, chrono::milliseconds(100),
+				[this, tail]() { return mDone || mHead.load(memory_order_acquire) - tail >= FlushBatch; });
+			done = mDone;
+			head = mHead.load(memory_order_acquire);
+		}
+		if (head == tail) {
+			if (done)
+				break;
+			continue;
+		}
+		while (file != nullptr && tail < head) {
+			long long start = tail & (Capacity - 1);
+			long long num = min(head - tail, Capacity - start);
+			fwrite(&mRing[start], sizeof(traceRecord), num, file);
+			tail += num;
+		}
+		tail = head;
+		if (file != nullptr)
+			fflush(file);
+		{
+			lock_guard<mutex> guard(mLock);
+			mTail.store(tail, memory_order_release);
+		}
+		mSpace.notify_one();
+	}
+	if (file != nullptr)
+		fclose(file);
+}
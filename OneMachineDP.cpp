@@ -20,6 +20,20 @@ OneMachineDPProblem::OneMachineDPProblem(const char* filename, double time, int
 		mInfo = fopen(infoPathFile, "w");
 }
 
+/************************************************************************************************************
+ * Read a warm start job order, job indices separated by white space as written to the solution path file	*
+ ************************************************************************************************************/
+void OneMachineDPProblem::setInitialOrder(const char* file)
+{
+	ifstream inFile(file);
+	int job;
+	if (!inFile)
+		throw ERROR << "Cannot open initial order file " << file;
+	mOptions.initOrder.clear();
+	while (inFile >> job)
+		mOptions.initOrder.push_back(job);
+}
+
 void OneMachineDPProblem::solve()
 {
 	mModel.initialize(&mOptions);
@@ -29,12 +43,22 @@ void OneMachineDPProblem::solve()
 	mModel.setOutInfo(mInfo);
 	int solution, flag;
 
-	solution = mModel.solve();
+	if (mOptions.biDir)
+		solution = mModel.solveBiDir(&mOptions);
+	else
+		solution = mModel.solve();
+	// All incumbents are delivered when solve returns
+	mModel.mStream->finish();
+	mModel.mTrace->finish();
+	mModel.mProgress->finish();
+	mModel.mTimeline->finish();
 	mModel.updatePercentage();
 	flag = mModel.mTerminateMode;
 
 	switch (flag) {
 	case 0:
+		if (mModel.mSolvedByRev)
+			printf("Optimality proved by reverse search.\n");
 		if (mModel.chkFinalSolution()) {
 			printf("The solution is correct.\n");
 		} else {
@@ -50,6 +74,18 @@ void OneMachineDPProblem::solve()
 		printf("Terminate. Time limit %f reached.\n", mModel.mTimeLim);
 		printf("Current global lower bound is %d.\n", mModel.globLB);
 		break;
+	case 3:
+		printf("Terminate. Memory limit %lld reached.\n", mModel.mMemLimit);
+		printf("Current global lower bound is %d.\n", mModel.globLB);
+		break;
+	case 5:
+		printf("Terminate. Target gap %f reached.\n", mModel.mTargetGap);
+		printf("Current global lower bound is %d.\n", mModel.globLB);
+		break;
+	case 6:
+		printf("Terminate. Open nodes dropped under memory budget %lld; gap not closed.\n", mModel.mMemBudget);
+		printf("Current global lower bound is %d.\n", mModel.globLB);
+		break;
 	default:
 		throw ERROR << "Termination Mode Error.";
 	}
@@ -80,7 +116,8 @@ void OneMachineDPProblem::printSolToJson()
 	
 	fprintf(mJson, ", \"strong\": %d, \"weak_1\": %d, \"weak_2\": %d", mModel.mBranching->mNumStrongBch, mModel.mBranching->mNumWeakBch1, mModel.mBranching->mNumWeakBch2);
 	
-	fprintf(mJson, ", \"updtHead\": %d, \"updtTail\": %d", mModel.mPost->mNumHeadUpdts, mModel.mPost->mNumTailUpdts);
+	fprintf(mJson, ", \"updtHead\": %d, \"updtTail\": %d, \"numRedo\": %d", mModel.mPost->mNumHeadUpdts, mModel.mPost->mNumTailUpdts,
+		mModel.mPost->mNumRedos);
 
 	fprintf(mJson, ", \"init_lb\": %d", mModel.initLB);
 
@@ -94,6 +131,101 @@ void OneMachineDPProblem::printSolToJson()
 
 	fprintf(mJson, ", \"maxDepth\": %d", mModel.maxDepth);
 
+	fprintf(mJson, ", \"numBulkPruned\": %d", mModel.numBulkPruned);
+
+	fprintf(mJson, ", \"peakOpenBytes\": %lld", mModel.mPeakOpenBytes);
+
+	fprintf(mJson, ", \"memory\": {\"current\": {");
+	for (int c = 0; c < NumMemCategories; c++)
+		fprintf(mJson, "\"%s\": %lld, ", OneMachDPData::memName(c), mModel.mMemBytes[c]);
+	fprintf(mJson, "\"total\": %lld}, \"peak\": {", mModel.memTotal());
+	for (int c = 0; c < NumMemCategories; c++)
+		fprintf(mJson, "\"%s\": %lld, ", OneMachDPData::memName(c), mModel.mPeakMemBytes[c]);
+	fprintf(mJson, "\"total\": %lld}, \"openAtPeak\": %d, \"bytesPerOpenNode\": %.1f", mModel.mPeakMemTotal, mModel.mInMemoryAtPeak,
+		(mModel.mInMemoryAtPeak > 0) ? (double)mModel.mNodeBytesAtPeak / mModel.mInMemoryAtPeak : 0.0);
+	if (mOptions.memLimit > 0)
+		fprintf(mJson, ", \"memLimit\": %lld", mOptions.memLimit);
+	fprintf(mJson, "}");
+
+	if (mOptions.memBudget > 0)
+		fprintf(mJson, ", \"memBudget\": %lld, \"numDives\": %d, \"diveIter\": %d, \"numDropped\": %d, \"maxNodeBytes\": %lld", mOptions.memBudget,
+			mModel.mNumDives, mModel.mNumDiveIter, mModel.mNumDropped, mModel.mMaxNodeBytes);
+
+	// A memory budget that is not lossy spills as well
+	if (mModel.mSpillBytes > 0)
+		fprintf(mJson, ", \"spillRuns\": %d, \"spilled\": %d, \"loaded\": %d, \"readAhead\": %d", mModel.mSpill->mNumRuns,
+			mModel.mSpill->mNumSpilled, mModel.mSpill->mNumLoaded, mModel.mSpill->mNumReadAhead);
+
+	if (!mOptions.streamFile.empty() || mOptions.onIncumbent != nullptr)
+		fprintf(mJson, ", \"incumbents\": %d", mModel.mStream->mNumPosted);
+
+	if (!mOptions.traceFile.empty())
+		fprintf(mJson, ", \"traceRecords\": %lld, \"traceStalls\": %lld", mModel.mTrace->mHead.load(), mModel.mTrace->mNumStalls);
+
+	if (!mOptions.timelineFile.empty())
+		fprintf(mJson, ", \"timelineEvents\": %d", mModel.mTimeline->mNumEvents);
+
+	if (mOptions.progressInterval > 0)
+		fprintf(mJson, ", \"progressReports\": %d", mModel.mProgress->mNumReports);
+
+	if (mModel.mRestart != NoRestart) {
+		fprintf(mJson, ", \"restarts\": %d, \"restartRuns\": [", mModel.mNumRestarts);
+		for (size_t i = 0; i < mModel.mRestartStats.size(); i++) {
+			const restartStat& stat = mModel.mRestartStats[i];
+			fprintf(mJson, "%s{\"budget\": %d, \"iter\": %d, \"nodes\": %d, \"ub\": %d, \"lb\": %d, \"time\": %ld}", (i == 0) ? "" : ", ",
+				stat.budget, stat.iter, stat.nodes, stat.ub, stat.lb, stat.elapsed);
+		}
+		fprintf(mJson, "]");
+	}
+
+	if (!mOptions.initOrder.empty())
+		fprintf(mJson, ", \"warmStartUB\": %d", mModel.mWarmUB);
+
+	if (mOptions.targetGap > 0)
+		fprintf(mJson, ", \"targetGap\": %f", mOptions.targetGap);
+
+	if (!mOptions.ckptFile.empty())
+		fprintf(mJson, ", \"checkpoints\": %d, \"ckptCompacts\": %d, \"resumed\": %d", mModel.mCheckpoint->mNumWrites,
+			mModel.mCheckpoint->mNumCompacts, mOptions.resume ? 1 : 0);
+
+	if (mOptions.lazyBound)
+		fprintf(mJson, ", \"lazyBounded\": %d, \"lazyReinsert\": %d", mModel.mBranching->mNumLazyBounded, mModel.mNumLazyReinsert);
+
+	vector<pair<int, int>> hist;
+	mModel.mRexSolCount.histogram(hist);
+	fprintf(mJson, ", \"rexSolHist\": [");
+	for (size_t i = 0; i < hist.size(); i++)
+		fprintf(mJson, "%s[%d, %d]", (i == 0) ? "" : ", ", hist[i].first, hist[i].second);
+	fprintf(mJson, "]");
+
+	if (mOptions.biDir)
+		fprintf(mJson, ", \"revIter\": %d, \"solvedByRev\": %d", mModel.mRevNumIter, mModel.mSolvedByRev ? 1 : 0);
+
+#ifdef OMDP_PROFILE
+	const OneMachDPProfile& prof = mModel.mProfile;
+	// Counted events are given per phase, -1 if the machine does not count them
+	bool hw = prof.mHwSlot[hwCycles] >= 0;
+	fprintf(mJson, ", \"profile\": {");
+	for (int phase = 0; phase < NumProfPhases; phase++) {
+		fprintf(mJson, "%s\"%s\": {\"calls\": %lld, \"totalNs\": %lld, \"p50Ns\": %lld, \"p90Ns\": %lld, \"p99Ns\": %lld",
+			(phase == 0) ? "" : ", ", OneMachDPProfile::phaseName(phase), prof.mCalls[phase], prof.mTotalNs[phase],
+			prof.percentile(phase, 0.5), prof.percentile(phase, 0.9), prof.percentile(phase, 0.99));
+		for (int e = 0; hw && e < NumHwEvents; e++)
+			fprintf(mJson, ", \"%s\": %lld", OneMachDPProfile::hwName(e), (prof.mHwSlot[e] >= 0) ? prof.mHw[phase][e] : -1);
+#ifdef OMDP_ALLOC_PROFILE
+		fprintf(mJson, ", \"allocs\": %lld, \"allocBytes\": %lld, \"allocsPerCall\": %.2f", prof.mAllocs[phase], prof.mAllocBytes[phase],
+			(prof.mCalls[phase] > 0) ? (double)prof.mAllocs[phase] / prof.mCalls[phase] : 0.0);
+#endif
+		fprintf(mJson, "}");
+	}
+	fprintf(mJson, "}");
+	if (prof.mHwRequested) {
+		fprintf(mJson, ", \"hwCounters\": %s", hw ? "true" : "false");
+		if (hw)
+			fprintf(mJson, ", \"hwRunningRatio\": %.3f", (prof.mHwEnabled > 0) ? (double)prof.mHwRunning / prof.mHwEnabled : 0.0);
+	}
+#endif
+
 	fprintf(mJson, "}\n");
 }
 
@@ -13,6 +13,16 @@
 #include<stack>
 #include<functional>
 #include<chrono>
+#include<thread>
+#include<mutex>
+#include<atomic>
+#include<condition_variable>
+#include<deque>
+#include<random>
+#include<cmath>
+#include<cstdarg>
+#include<memory>
+#include<future>
 //#include<vld.h>
 
 using namespace std;
@@ -28,12 +38,20 @@ class OneMachDPPost;
 class OneMachDPBranch;
 class OneMachDPCritPath;
 class OneMachDPUtil;
-typedef multimap<int, OneMachDPNode*> NodesMap;
-typedef map<int, NodesMap> ContourMap;
+class OneMachDPIndex;
+class OneMachDPSpill;
+class OneMachDPCheckpoint;
+class OneMachDPStream;
+class OneMachDPTrace;
+class OneMachDPProgress;
+class OneMachDPTimeline;
+class OneMachDPHeap;
+typedef map<int, OneMachDPHeap> ContourMap;
+typedef map<int, vector<OneMachDPNode*>> LBBuckets;
 typedef map<int, int> LBMap;
+class OneMachDPCounter;
 typedef chrono::steady_clock myclock;
-typedef list<fixedEdge*> edgePtrList;
-typedef list<fixedEdge> edgeList;
+typedef vector<fixedEdge> edgeList;
 typedef list<JobStep*>::iterator iterJobs;
 typedef chrono::high_resolution_clock myclock;
 
@@ -56,16 +74,261 @@ public:
 } JobStep;
 
 /************************************************************************************************************
- * Stores information about precedence contraints															*
+ * Stores information about precedence contraints, jobsteps are given by job index							*
  ************************************************************************************************************/
 typedef struct fixedEdge
 {
-	JobStep* from;
-	JobStep* to;
+	int from;
+	int to;
 	int delay;
-	fixedEdge(JobStep* pred, JobStep* succ, int time) : from(pred), to(succ), delay(time) {}
+	fixedEdge(int pred, int succ, int time) : from(pred), to(succ), delay(time) {}
 } fixedEdge;
 
+/************************************************************************************************************
+ * Stores precedence contraints of each jobstep in CSR form: the edges of job j are edges[start[j]] to		*
+ * edges[start[j] + count[j] - 1], each an index in the edge list it is built from. Slots up to			*
+ * start[j + 1] are spare, so a fix added to a node goes into its row without moving the others				*
+ ************************************************************************************************************/
+typedef struct fixAdjacency
+{
+	vector<int> start;
+	vector<int> count;
+	vector<int> edges;
+	int begin(int job) const { return start[job]; }
+	int end(int job) const { return start[job] + count[job]; }
+	int size(int job) const { return count[job]; }
+	bool empty(int job) const { return count[job] == 0; }
+	void build(const edgeList& fixes, int numJobs, bool bySucc, int spare = 0);
+	void build(const fixAdjacency& init, const edgeList& fixes, int numJobs, bool bySucc, int spare = 0);
+	void reset(int numJobs);
+	void insert(int job, int edge);
+	void clear() { vector<int>().swap(start); vector<int>().swap(count); vector<int>().swap(edges); }
+	static const int Spare = 2;										// Spare slots per row while a node is in process
+private:
+	void grow(int job);
+} fixAdjacency;
+
+/************************************************************************************************************
+ * Heads and tails of all jobsteps by job index, as a parent had them when it branched. One copy is shared	*
+ * by its lazy children until they are bounded																*
+ ************************************************************************************************************/
+typedef struct edgeSnapshot
+{
+	vector<int> head;
+	vector<int> tail;
+} edgeSnapshot;
+
+/************************************************************************************************************
+ * 4-ary min heap of open nodes of one contour, ordered by (best, tie, seq). Each node keeps its position	*
+ * in mHeapPos as handle, so a node is removed without searching for it										*
+ ************************************************************************************************************/
+typedef struct heapEntry
+{
+	int best;									// Measure of best, LB or parent solution
+	int tie;									// Tie breaking key, depends on tie breaking rule
+	int seq;									// Insertion sequence, last resort of tie breaking
+	OneMachDPNode* node;
+	heapEntry(int b, int t, int s, OneMachDPNode* n) : best(b), tie(t), seq(s), node(n) {}
+	bool operator< (const heapEntry& other) const
+	{
+		if (best != other.best) return best < other.best;
+		if (tie != other.tie) return tie < other.tie;
+		return seq < other.seq;
+	}
+} heapEntry;
+
+class OneMachDPHeap
+{
+public:
+	void push(const heapEntry& entry);
+	void erase(OneMachDPNode* node);
+	OneMachDPNode* top() const { return mEntries.front().node; }
+	bool empty() const { return mEntries.empty(); }
+	int size() const { return mEntries.size(); }
+	long long memBytes() const { return (long long)mEntries.capacity() * sizeof(heapEntry); }
+private:
+	void place(int pos, const heapEntry& entry);
+	void siftUp(int pos);
+	void siftDown(int pos);
+	vector<heapEntry> mEntries;
+};
+
+/************************************************************************************************************
+ * Count of nodes per bound value. Values are kept in a dense array from mBase, with the smallest value		*
+ * counted cached in mMin; a value range wider than MaxDenseSpan falls back to a map							*
+ ************************************************************************************************************/
+class OneMachDPCounter
+{
+public:
+	OneMachDPCounter() : mBase(0), mMin(MaxInt), mTotal(0), mDense(true) {}
+	void add(int value, int num = 1);
+	bool remove(int value);
+	int min();
+	int count(int value) const;
+	int countBelow(int value) const;
+	int countAbove(int value) const;
+	int total() const { return mTotal; }
+	void histogram(vector<pair<int, int>>& out) const;
+	long long memBytes() const;
+	static const int MaxDenseSpan = 1 << 20;
+private:
+	void grow(int value);
+	int mBase, mMin, mTotal;
+	bool mDense;
+	vector<int> mCounts;
+	LBMap mSparse;
+};
+
+/************************************************************************************************************
+ * Categories of memory accounting. The first NumNodeMem are held by open nodes and are updated as nodes	*
+ * enter and leave the open list; the open list structures and histograms are measured periodically. A map	*
+ * entry is taken as MAP_NODE_BYTES of tree links on top of its value										*
+ ************************************************************************************************************/
+enum memCategory { memNodeObj, memFixes, memAdjacency, memSchedule, memPaths, NumNodeMem = memPaths + 1, memContours = NumNodeMem,
+	memLBBuckets, memHistograms, NumMemCategories };
+
+#define MAP_NODE_BYTES (4 * sizeof(void*))
+
+/************************************************************************************************************
+ * Time spent in the phases of node processing. Build with OMDP_PROFILE defined to collect it, otherwise	*
+ * PROFILE_SCOPE compiles to nothing. Times are inclusive, a phase called inside another counts in both.	*
+ * Durations go to log-linear buckets, four per power of two, for percentiles								*
+ ************************************************************************************************************/
+enum profPhase { profUpdateEdge, profGetUB, profGetUBMod2, profCritPath, profPost, profBrchScn, profSolveRev, profBranch,
+	profGetLBStd, profSolveNode, profOther, NumProfPhases };
+// profOther is never timed, it takes the allocations of the search loop outside solveNode
+
+/************************************************************************************************************
+ * Hardware counters read around each phase when requested, on Linux through perf_event_open. An event the	*
+ * machine does not count is reported as -1; without the cycle counter only times are collected			*
+ ************************************************************************************************************/
+enum hwEvent { hwCycles, hwInstructions, hwLLCMisses, hwBranchMisses, NumHwEvents };
+
+/************************************************************************************************************
+ * Allocation profiling: with OMDP_ALLOC_PROFILE defined, which implies OMDP_PROFILE, a global operator new	*
+ * counts each allocation and its bytes in the innermost profiled phase of the allocating thread. Unlike	*
+ * times, counts are exclusive; allocations outside any phase are not counted								*
+ ************************************************************************************************************/
+#if defined(OMDP_ALLOC_PROFILE) && !defined(OMDP_PROFILE)
+#define OMDP_PROFILE
+#endif
+
+class OneMachDPProfile
+{
+public:
+	OneMachDPProfile() : mHwRequested(false), mHwActive(false), mTimeline(nullptr) { clear(); }
+	void clear();
+	void add(int phase, long long ns);
+	void addHw(int phase, const long long* delta);
+	long long percentile(int phase, double p) const;
+	static const char* phaseName(int phase);
+	static const char* hwName(int event);
+	static const int NumBuckets = 256;
+	void openCounters();
+	void readCounters(long long* values);
+	void closeCounters();
+
+	long long mTotalNs[NumProfPhases];
+	long long mCalls[NumProfPhases];
+	long long mHw[NumProfPhases][NumHwEvents];
+	long long mAllocs[NumProfPhases], mAllocBytes[NumProfPhases];
+	bool mHwRequested;							// Counters were asked for
+	bool mHwActive;								// Counters are open, at least the cycle counter
+	int mHwSlot[NumHwEvents];					// Position of each event in the group read, -1 if not counted
+	long long mHwEnabled, mHwRunning;			// Time the group was enabled and counting, they differ when multiplexed
+	OneMachDPTimeline* mTimeline;				// Receives the phases of sampled nodes, nullptr if none
+private:
+	int mBuckets[NumProfPhases][NumBuckets];
+	int mHwFds[NumHwEvents];
+	int mNumHwOpen;
+};
+
+#ifdef OMDP_ALLOC_PROFILE
+extern thread_local OneMachDPProfile* tAllocProfile;		// Profile and phase charged with allocations of this thread
+extern thread_local int tAllocPhase;
+#endif
+
+class profileScope
+{
+public:
+	profileScope(OneMachDPProfile& prof, int phase) : mProf(prof), mPhase(phase)
+	{
+#ifdef OMDP_ALLOC_PROFILE
+		mPrevProfile = tAllocProfile;
+		mPrevPhase = tAllocPhase;
+		tAllocProfile = &prof;
+		tAllocPhase = phase;
+#endif
+		if (mProf.mHwActive)
+			mProf.readCounters(mStartHw);
+		mStart = myclock::now();
+	}
+	~profileScope();
+private:
+	OneMachDPProfile& mProf;
+	int mPhase;
+	myclock::time_point mStart;
+	long long mStartHw[NumHwEvents];
+#ifdef OMDP_ALLOC_PROFILE
+	OneMachDPProfile* mPrevProfile;
+	int mPrevPhase;
+#endif
+};
+
+#ifdef OMDP_PROFILE
+#define PROFILE_SCOPE(prof, phase) profileScope _profScope(prof, phase)
+#else
+#define PROFILE_SCOPE(prof, phase)
+#endif
+
+#ifdef OMDP_ALLOC_PROFILE
+/************************************************************************************************************
+ * Charge allocations of this thread to phase of prof, without timing it									*
+ ************************************************************************************************************/
+class allocScope
+{
+public:
+	allocScope(OneMachDPProfile& prof, int phase) : mPrevProfile(tAllocProfile), mPrevPhase(tAllocPhase)
+	{
+		tAllocProfile = &prof;
+		tAllocPhase = phase;
+	}
+	~allocScope()
+	{
+		tAllocProfile = mPrevProfile;
+		tAllocPhase = mPrevPhase;
+	}
+private:
+	OneMachDPProfile* mPrevProfile;
+	int mPrevPhase;
+};
+#define ALLOC_SCOPE(prof, phase) allocScope _allocScope(prof, phase)
+#else
+#define ALLOC_SCOPE(prof, phase)
+#endif
+
+/************************************************************************************************************
+ * Leveled diagnostics. Levels above OMDP_LOG_LEVEL (LogInfo unless defined at build time) are compiled		*
+ * out, arguments included; the rest are filtered again at run time by mLevel, which is process wide		*
+ ************************************************************************************************************/
+enum logLevel { LogError, LogWarn, LogInfo, LogDebug, LogTrace };
+
+#ifndef OMDP_LOG_LEVEL
+#define OMDP_LOG_LEVEL LogInfo
+#endif
+
+class OneMachDPLog
+{
+public:
+	static void write(const char* format, ...);
+
+	static int mLevel;
+	static FILE* mFile;
+};
+
+#define OMDP_LOG_ENABLED(level) ((level) <= OMDP_LOG_LEVEL && (level) <= OneMachDPLog::mLevel)
+#define OMDP_LOG(level, ...) do { if (OMDP_LOG_ENABLED(level)) OneMachDPLog::write(__VA_ARGS__); } while (0)
+
 /************************************************************************************************************
  * Stores information about critical path check																*
  ************************************************************************************************************/
@@ -81,6 +344,57 @@ typedef struct critPathCheck
 		type(tp), numPrecInCritPath(num), stepsAftCritStep(stepsAftCrit), critJob(step), lastPrecStep(preStep) {}
 } critPathCheck;
 
+/************************************************************************************************************
+ * Stores incumbent shared between the forward and reverse search (job order is in forward direction)		*
+ ************************************************************************************************************/
+typedef struct sharedIncumbent
+{
+	mutex lock;
+	atomic<int> ub;
+	atomic<bool> stop;						// Set by the first search that terminates
+	vector<int> bstOrder;					// Job indices of best schedule, forward direction
+	sharedIncumbent() : ub(MaxInt), stop(false) {}
+} sharedIncumbent;
+
+/************************************************************************************************************
+ * A new incumbent, as passed to the incumbent stream														*
+ ************************************************************************************************************/
+typedef struct incumbentEvent
+{
+	int makespan, iter;
+	long elapsed;							// Milliseconds since the search started
+	vector<int> order;						// Job indices in sequence order
+} incumbentEvent;
+typedef function<void(const incumbentEvent&)> incumbentCallback;
+
+/************************************************************************************************************
+ * One explored or pruned node in the binary search tree trace. The file is a header of TRACE_MAGIC,		*
+ * TRACE_VERSION, the record size in bytes and the number of jobs, followed by the raw records				*
+ ************************************************************************************************************/
+#define TRACE_MAGIC 0x54444D4F
+#define TRACE_VERSION 1
+
+typedef struct traceRecord
+{
+	int iter, flag;							// Iteration, and solveNode result or 5 if pruned before exploration
+	int nodeID, LB, rexSol, feaSol;
+	int numFix, critLen;					// Fixed edges, and critical path length, -1 if pruned
+	int contour, depth;
+	int left, right;						// Child node IDs, -1 if not branched
+} traceRecord;
+
+/************************************************************************************************************
+ * Statistics of one run between restarts																	*
+ ************************************************************************************************************/
+typedef struct restartStat
+{
+	int budget, iter, nodes;				// Node budget of the run, and nodes explored and created by it
+	int ub, lb;								// globUB and globLB when the run ended
+	long elapsed;							// Milliseconds since the search started
+} restartStat;
+
+enum restartMode { NoRestart, Luby, Geometric };
+
 /************************************************************************************************************
  * Stores information about options to initialize solver													*
  ************************************************************************************************************/
@@ -92,9 +406,38 @@ typedef struct options
 	tbMode tb;
 	bool revChk;
 	bool heuChk;
-	options() {}
-	options(double time, int iter, Mode m) : timeLimit(time), iterationLimit(iter), mod(m) { revChk = false; }
-	options(double time, int iter, Mode m, bool r) : timeLimit(time), iterationLimit(iter), mod(m), revChk(r) {}
+	bool biDir;								// Run the reverse problem search concurrently
+	bool lazyBound;							// Bound child nodes when selected instead of when created. The two children share a copy of the parent's heads and tails until then
+	long long memBudget;					// Bytes of open nodes, over it the search dives and pages the worst nodes out to spillDir, 0 for no limit
+	bool memBudgetLossy;					// Drop the worst nodes over memBudget instead of paging them out, the gap may then stay open
+	long long spillBytes;					// Bytes of open nodes before spilling to disk, 0 for no spilling
+	string spillDir;						// Directory of spilled run files
+	string ckptFile;						// Checkpoint file, empty for no checkpoints
+	double ckptInterval;					// Seconds between checkpoints
+	bool resume;							// Continue the search saved in ckptFile
+	unsigned int seed;						// Seed of the solver RNG, 0 to draw it from rand()
+	string streamFile;						// File or pipe receiving each new incumbent, empty for none
+	incumbentCallback onIncumbent;			// Called with each new incumbent, on the stream thread
+	double targetGap;						// Stop when (globUB - globLB) / globUB is not larger, 0 for none
+	vector<int> initOrder;					// Job order taken as first incumbent, empty for none
+	restartMode restart;					// Restart policy of ARB tie breaking
+	int restartBase;						// Node budget of the first run
+	double restartFactor;					// Budget growth of geometric restarts
+	string traceFile;						// Binary search tree trace, empty for none
+	long long memLimit;						// Bytes of accounted memory that end the search, 0 for no limit
+	bool hwCounters;						// Hardware counters per phase, in builds with OMDP_PROFILE
+	double progressInterval;				// Seconds between progress reports, 0 for none
+	string progressFile;					// File of progress reports, one JSON object each, empty for stdout
+	string timelineFile;					// Chrome trace event file of the search timeline, empty for none
+	int timelineEvery;						// Sample every k-th node into the timeline
+	options() : biDir(false), lazyBound(false), memBudget(0), memBudgetLossy(false), spillBytes(0), spillDir("."), ckptInterval(60), resume(false), seed(0), targetGap(0), restart(NoRestart),
+		restartBase(1000), restartFactor(1.5), memLimit(0), hwCounters(false), progressInterval(0), timelineEvery(1) {}
+	options(double time, int iter, Mode m) : timeLimit(time), iterationLimit(iter), mod(m), biDir(false), lazyBound(false), memBudget(0),
+		memBudgetLossy(false), spillBytes(0), spillDir("."), ckptInterval(60), resume(false), seed(0), targetGap(0), restart(NoRestart),
+		restartBase(1000), restartFactor(1.5), memLimit(0), hwCounters(false), progressInterval(0), timelineEvery(1) { revChk = true; }
+	options(double time, int iter, Mode m, bool r) : timeLimit(time), iterationLimit(iter), mod(m), revChk(r), biDir(false), lazyBound(false),
+		memBudget(0), memBudgetLossy(false), spillBytes(0), spillDir("."), ckptInterval(60), resume(false), seed(0), targetGap(0), restart(NoRestart),
+		restartBase(1000), restartFactor(1.5), memLimit(0), hwCounters(false), progressInterval(0), timelineEvery(1) {}
 } options;
 
 /************************************************************************************************************
@@ -130,22 +473,45 @@ class OneMachDPData
 public:
 	OneMachDPData() {}
 	OneMachDPData(const char* filename);
+	OneMachDPData(istream& inStream);
+	OneMachDPData(OneMachDPData* org);
+	void readInstance(istream& inFile);
 	void initialize(options* opt);
 	int solve();
+	int solveBiDir(options* opt);
+	void syncIncumbent();
+	void publishIncumbent();
+	void streamIncumbent();
+	void measureOpenList();
+	void updateMemPeak();
+	long long memTotal();
+	static const char* memName(int category);
+	void traceNode(OneMachDPNode* node, int flag);
+	void seedIncumbent(const vector<int>& order);
 	int solveNode(OneMachDPNode* node);
 	int solveRevNode(OneMachDPNode* node);
 	int chkDelayJobCritPathes(OneMachDPNode* node);
 	int LLTHs(OneMachDPNode* node);
 
 	void addNode(OneMachDPNode* node);
+	void enforceBudget(OneMachDPNode* pushed);
 	void delNode(OneMachDPNode* node);
+	void attachNode(OneMachDPNode* node);
+	void detachNode(OneMachDPNode* node);
+	void rekeyNode(OneMachDPNode* node, int newLB);
+	heapEntry makeHeapEntry(OneMachDPNode* node);
+	void addToLBBucket(OneMachDPNode* node);
+	void removeFromLBBucket(OneMachDPNode* node);
 	void dumpAllNodes();
+	void clearOpenNodes();
+	void restart();
+	int restartBudget(int run);
+	void pruneOpenNodes();
 	void resetTailUpdateChk();
 	void printJobsteps();
 	void printInfo(OneMachDPNode* node);
 	void cleanUp();
 	OneMachDPNode* getNextNode();
-	OneMachDPNode* getNextNode(tbMode tbRule);
 	JobStep* getJobStep(int jobIndex);
 
 	int calContour(OneMachDPNode* node);
@@ -171,6 +537,9 @@ public:
 	int initLB;
 	int curID;
 	int numToExplore, numIter, bstFoundAtIter, bstFoundCritSize;
+	int numInserted;							// Insertion sequence of open nodes
+	int numBulkPruned, prunedAtUB;				// Open nodes freed by incumbent improvements, and the UB of last sweep
+	int mNumLazyReinsert;						// Lazy children put back to the open list after bounding
 	int leftConst, rightConst;
 	int numJobs;                                // Number of job steps
 	int numInitFix;								// Number of precedence constraint
@@ -178,10 +547,8 @@ public:
 	int maxDepth;
 	
 	list<JobStep> mJobsData;
-	list<fixedEdge> mInitFix;                   // List of starting precedence arcs
+	edgeList mInitFix;                          // List of starting precedence arcs
 	vector<JobStep*> mJobsByIndex;				// vector of job ptr for easy access
-	vector<edgePtrList> mInitPreds;
-	vector<edgePtrList> mInitSuccs;
 	vector<int> mInitHead, mInitTail;			// array store the initial head and tail
 	vector<int> testHeuRes;
 	vector<vector<int>> mInitFixDPDelay;		// 2 dimensional vector to store delay for initial precedence arcs
@@ -191,21 +558,65 @@ public:
 	OneMachDPBranch* mBranching;				// Branching module
 	OneMachDPPost* mPost;
 	OneMachDPUtil* mUtil;
+	const OneMachDPIndex* mIndex;				// Read-only instance invariants, built in initialize
 	OneMachDPCritPath* mCritPathes;
-	OneMachDPCritPath* mRevCritPathes;
-	LBMap mLowerBd;
-	LBMap mRexSolCount;
-	ContourMap mContours;                       // Use map to store contours
+	OneMachDPCounter mLowerBd;					// LB of open nodes
+	OneMachDPCounter mRexSolCount;				// Relaxed solution of all nodes created
+	ContourMap mContours;                       // Use map to store contours, one heap of open nodes each
 	ContourMap::iterator mCurContour;           // Iterator to enable cycling through contours
 	ContourMap::iterator mPreContour;
+	LBBuckets mOpenByLB;						// Open nodes grouped by LB, for pruning on new incumbent
 	stack<OneMachDPNode*> mNodesStack;          // Stack for DFS
 	string mOneMachineName;                     // name of the problem
 
 	double mTimeLim;
 	int mIterLim, mTerminateMode;
 	int mNumLLTH;
+	int mRevNumIter;							// Iterations of the concurrent reverse search
+	bool mIsRev, mSolvedByRev;					// mIsRev: this is the reverse problem; mSolvedByRev: reverse search proved optimality
+	sharedIncumbent* mShared;					// Incumbent shared with concurrent search, nullptr if not used
+	int mSyncedUB;								// Value of the shared incumbent last taken by syncIncumbent
 	long mElapsTime;
 	bool mRevChkOn, mCombineOn, mCombineOnRev;
+	bool mLazyOn;								// Lazy bounding of child nodes
+	long long mMemBudget;						// Budget of open node bytes, 0 for no limit
+	bool mBudgetLossy;							// Open nodes over budget are dropped instead of paged out
+	long long mOpenBytes, mPeakOpenBytes;		// Estimated bytes held by open nodes, and its maximum
+	long long mMaxNodeBytes;					// Largest estimate of a single open node
+	long long mMemBytes[NumMemCategories];		// Accounted bytes by category
+	long long mPeakMemBytes[NumMemCategories];	// Maximum of each category
+	long long mPeakMemTotal;					// High-water mark of all categories together
+	long long mNodeBytesAtPeak;					// Bytes of open nodes at the high-water mark
+	int mNumInMemory, mInMemoryAtPeak;			// Open nodes not spilled, now and at the high-water mark
+	long long mMemLimit;						// Hard limit of accounted bytes, 0 for none
+	bool mDiving;								// Open nodes are over budget, search dives depth first
+	int mNumDives, mNumDiveIter;				// Number of dives started, and nodes selected while diving
+	int mNumDropped, mDroppedLB;				// Open nodes dropped to keep the budget, and their smallest LB
+	OneMachDPNode* mDiveNext;					// Best child of last explored node, next node while diving
+	long long mSpillBytes;						// Open node bytes before spilling to disk, at most a budget that is not lossy, 0 for no spilling
+	string mSpillDir;
+	OneMachDPSpill* mSpill;						// Open nodes spilled to run files
+	OneMachDPCheckpoint* mCheckpoint;			// Journal of the search state for resuming
+	bool mResume;								// Start from the checkpoint instead of the root
+	mt19937 mRng;								// Solver RNG, saved with checkpoints
+#ifdef OMDP_PROFILE
+	OneMachDPProfile mProfile;					// Time per phase of node processing
+#endif
+	OneMachDPStream* mStream;					// Sink of new incumbents
+	OneMachDPTrace* mTrace;						// Binary trace of explored nodes
+	OneMachDPProgress* mProgress;				// Periodic report of the search state
+	OneMachDPTimeline* mTimeline;				// Trace event timeline of sampled nodes
+	double mTargetGap;
+	vector<int> mInitOrder;						// Warm start job order
+	int mWarmUB;								// Makespan of the warm start order
+	restartMode mRestart;
+	int mRestartBase;
+	double mRestartFactor;
+	int mNumRestarts, mRunBudget;				// Restarts done, and node budget of the current run
+	int mRunStartIter, mRunStartNodes;			// numIter and numNodes when the current run started
+	int mProvenLB;								// Best globLB of the runs before the last restart
+	vector<restartStat> mRestartStats;
+	myclock::time_point mStartTime;
 	Mode mMode;                                 // Control the contour mode
 	tbMode mTbMode;
 	int mMesrBest;								// Determine the measure of best criteria
@@ -221,6 +632,25 @@ public:
 	OneMachineDPProblem(const char* filename, double time, int iter, Mode mod, tbMode tb, bool revChk, bool heuChk,
 		char* jsonFile, char* solPathFile, char* critPathFile, char* infoPathFile);
 	void solve();
+	void setBiDir(bool biDir) { mOptions.biDir = biDir; }
+	void setLazyBound(bool lazy) { mOptions.lazyBound = lazy; }
+	void setMemBudget(long long bytes, bool lossy = false) { mOptions.memBudget = bytes; mOptions.memBudgetLossy = lossy; }
+	void setSpill(const char* dir, long long bytes) { mOptions.spillDir = dir; mOptions.spillBytes = bytes; }
+	void setCheckpoint(const char* file, double seconds) { mOptions.ckptFile = file; mOptions.ckptInterval = seconds; }
+	void setResume(bool resume) { mOptions.resume = resume; }
+	void setSeed(unsigned int seed) { mOptions.seed = seed; }
+	void setIncumbentStream(const char* file) { mOptions.streamFile = file; }
+	void setIncumbentCallback(incumbentCallback callback) { mOptions.onIncumbent = callback; }
+	void setTargetGap(double gap) { mOptions.targetGap = gap; }
+	void setInitialOrder(const vector<int>& order) { mOptions.initOrder = order; }
+	void setInitialOrder(const char* file);
+	void setRestart(restartMode mode, int base, double factor) { mOptions.restart = mode; mOptions.restartBase = base; mOptions.restartFactor = factor; }
+	void setTrace(const char* file) { mOptions.traceFile = file; }
+	void setMemLimit(long long bytes) { mOptions.memLimit = bytes; }
+	void setHwCounters(bool on) { mOptions.hwCounters = on; }
+	void setTimeline(const char* file, int every = 1) { mOptions.timelineFile = file; mOptions.timelineEvery = every; }
+	void setProgress(double seconds, const char* file = "") { mOptions.progressInterval = seconds; mOptions.progressFile = file; }
+	void setLogLevel(logLevel level, FILE* file = stdout) { OneMachDPLog::mLevel = level; OneMachDPLog::mFile = file; }
 	void printSolToJson();
 	void printBranching();
 	void cleanup();
@@ -237,14 +667,17 @@ public:
 class OneMachDPNode
 {
 public:
-	OneMachDPNode() {}
+	OneMachDPNode() : isInMap(false) {}
 	OneMachDPNode(OneMachDPData* oneMach);
 	OneMachDPNode(OneMachDPNode* pre);
 	OneMachDPNode(OneMachDPNode* org, bool inMap);
 	~OneMachDPNode();
 	void doedge();
 	void undoedge();
+	static shared_ptr<const edgeSnapshot> saveEdge(OneMachDPData* omdp);
+	void doParentEdge();
 	void updateEdge();
+	void updateEdge(vector<int> &headJobs, vector<int> &tailJobs);
 	void populateFixes();
 	void addFix(JobStep* from, JobStep* to, int delay);
 	void addFixNoChk(JobStep* from, JobStep* to, int delay);
@@ -254,6 +687,10 @@ public:
 	void updateHeadInSol();
 	void cleanConstrs();
 	void clearAll();
+	long long memBytes(int* bytes);
+	void pack(vector<int>& buf);
+	static OneMachDPNode* unpack(OneMachDPData* omdp, const int* rec, int& pos);
+	static void skip(const int* rec, int& pos);
 
 	bool haveDPC(int fromIndex, int toIndex);
 	bool havePrecConstr(int fromIndex, int toIndex, int remGap);
@@ -286,13 +723,21 @@ public:
 	JobStep* mSpecialStep;
 	JobStep* mLastPrecStep;
 	edgeList allFixes;
-	vector<edgePtrList> mAllPreds;
-	vector<edgePtrList> mAllSuccs;
+	fixAdjacency mAllPreds;								// Fixes into each job, by index in allFixes
+	fixAdjacency mAllSuccs;								// Fixes out of each job, by index in allFixes
 	int mLBound, mRexSol, mFeaSol, mParentSol;
 	int mSumProc, mMinHead, mMinTail;					// LocalLB, minHead and minTail for JobStep set J (on critical path from critical jobstep to end)
 	int mNodeID, mParentID;								// mNodeID to keep track of them, and mParent is parent ID
 	int mContour, mDepth;								// Keep track of the node's position in the search tree
 	int mLweight, mRweight;
+	int mHeapPos;										// Position in the heap of its contour while open
+	int mTieKey, mHeapSeq;								// Heap key drawn when first queued, -1 sequence before that
+	int mLBPos;											// Position in its LB bucket of the open list while open
+	bool mBounded;										// False for a lazy child until its LB is computed
+	shared_ptr<const edgeSnapshot> mParentEdge;			// Parent's heads and tails a lazy child is bounded from
+	int mBytes[NumNodeMem];								// Estimated bytes by category, counted in mMemBytes while open
+	bool mJournaled;									// Record of the node is in the checkpoint file
+	int mCkptPos;										// Position in the pending list of the checkpoint
 	bool isInMap;
 };
 
@@ -323,6 +768,7 @@ public:
 	int getLBStd(OneMachDPNode* node, list<JobStep*> &jobsToSchd);
 	int getLBFromSol(OneMachDPNode* node);
 	int getUB(OneMachDPNode* node);
+	int getUBRev(OneMachDPNode* node, list<JobStep*> &revSolPath);
 	int getUBMod(OneMachDPNode* node);
 	int getUBMod2(OneMachDPNode* node);
 	int getUBMod3(OneMachDPNode* node);
@@ -340,8 +786,10 @@ public:
 	bool main(OneMachDPNode* node);
 	bool chkPrecedPost(OneMachDPNode* node);
 	bool chkSuccedPost(OneMachDPNode* node);
-	int mNumHeadUpdts, mNumTailUpdts;
+	int mNumHeadUpdts, mNumTailUpdts, mNumRedos;
 	int mCurJobErased;
+	vector<int> mNewPredJobs;										// Jobs that received new predecessors in last tail update pass
+	vector<int> mTailUpdtJobs;										// Jobs whose tail or successors changed in last tail update pass
 	list<JobStep*>* mCurPath;
 	OneMachDPData* mOneMachDPData;
 	FILE* mJsonFile;
@@ -353,6 +801,7 @@ public:
 	OneMachDPBranch() {}
 	OneMachDPBranch(OneMachDPData* omdp) : mOneMachDPData(omdp) {}
 	int main(OneMachDPNode* node, int BrchScn);
+	int boundChild(OneMachDPNode* node);
 	int increRevCount() { mNumRevBrch++; return mNumRevBrch; }
 	void initialize();
 	OneMachDPData* mOneMachDPData;
@@ -362,6 +811,7 @@ public:
 	int mFixMoreCount;
 	int mNumDiscarded;													// Number of nodes discarded during branching because its LB > global UB
 	int mNumNodes, mNumNodesInitLB;
+	int mNumLazyBounded;												// Lazy children bounded when selected
 	int curLeft, curRight;
 	bool mRevChkOn;
 	FILE* mJsonFile;
@@ -394,6 +844,236 @@ public:
 	FILE* mJsonFile;
 };
 
+/************************************************************************************************************
+ * Invariants of the instance, built once from the initial precedence arcs and never changed afterwards,	*
+ * so that it can be read by all modules and concurrent searches without locking								*
+ ************************************************************************************************************/
+class OneMachDPIndex
+{
+public:
+	OneMachDPIndex(OneMachDPData* omdp);
+
+	int mNumJobs;
+	fixAdjacency mInitPreds;										// Initial arcs into each job, by index in mInitFix
+	fixAdjacency mInitSuccs;										// Initial arcs out of each job, by index in mInitFix
+	edgeList mDPCFix;												// Distinct initial arcs with nonzero delay
+	fixAdjacency mDPCSuccs;											// Row lists of DPCs, by index in mDPCFix
+private:
+	void checkAcyclic(const edgeList& fixes);
+};
+
+/************************************************************************************************************
+ * A run file of spilled open nodes, written in ascending LB. A run is paged in by LB, from the front, so	*
+ * it describes the part of the file not read yet															*
+ ************************************************************************************************************/
+typedef struct spillRun
+{
+	string path;
+	int numNodes;
+	vector<pair<int, int>> lbCounts;								// Number of nodes of each LB, ascending
+	vector<long> offsets;											// File offset of each LB, then of the end
+	vector<int> nodeIDs;
+	spillRun() : numNodes(0) {}
+} spillRun;
+
+class OneMachDPSpill
+{
+public:
+	OneMachDPSpill() {}
+	OneMachDPSpill(OneMachDPData* omdp) : mOneMachDPData(omdp) {}
+	void initialize();
+	void spill();
+	void loadDue();
+	void pruneRuns();
+	void dropAll();
+	bool empty() const { return mRuns.empty(); }
+
+	int mNumRuns, mNumSpilled, mNumLoaded;
+	int mNumReadAhead;												// Runs whose first LB was read ahead when paged in
+	multimap<int, spillRun> mRuns;									// Runs on disk by smallest LB
+	OneMachDPData* mOneMachDPData;
+private:
+	void loadRun(multimap<int, spillRun>::iterator run, int memLB);
+	void dropRun(multimap<int, spillRun>::iterator run);
+	void readAhead();
+	void cancelReadAhead();
+	static vector<int> readPart(string path, long begin, long end);
+	future<vector<int>> mAhead;										// First LB of the run due next, read on a background thread
+	string mAheadPath;												// File and offset mAhead reads from, empty for none
+	long mAheadBegin;
+};
+
+/************************************************************************************************************
+ * Checkpoint file: an append-only journal of blocks. Each checkpoint appends the open nodes created and	*
+ * the journaled nodes closed since the last one, then the counters, the incumbent and the RNG state.		*
+ * The journal is rewritten to its live part once it grows well beyond the open list. A resumed search	*
+ * follows the same path as an uninterrupted one, except under a memory budget or spill limit: restored	*
+ * nodes are estimated smaller than the nodes they were, and all of them are restored into memory			*
+ ************************************************************************************************************/
+typedef struct ckptImage
+{
+	map<int, vector<int>> nodes;									// Packed records of open nodes by node ID
+	vector<int> header, state, incumbent, rexSolHist;
+	string rng;
+	long long numRecords;											// Node and deletion records in the file
+	ckptImage() : numRecords(0) {}
+} ckptImage;
+
+class OneMachDPCheckpoint
+{
+public:
+	OneMachDPCheckpoint() {}
+	OneMachDPCheckpoint(OneMachDPData* omdp) : mOneMachDPData(omdp) {}
+	void initialize(const string& path, double interval);
+	long start(bool resume);
+	bool due(long elapsed) const { return mActive && elapsed - mLastWrite >= mInterval; }
+	void write(long elapsed);
+	void close(long elapsed);
+	void nodeAdded(OneMachDPNode* node);
+	void nodeDeleted(OneMachDPNode* node);
+	void nodeSpilled(OneMachDPNode* node);
+	void idDeleted(int nodeID);
+
+	bool mActive;
+	int mNumWrites, mNumCompacts;
+	OneMachDPData* mOneMachDPData;
+private:
+	long restore();
+	void removePending(OneMachDPNode* node);
+	void stateFields(vector<int*>& fields);
+	void fillImage(ckptImage& image, long elapsed);
+	void readImage(ckptImage& image);
+	void writeImage(const ckptImage& image);
+	void writeTail(FILE* file, const ckptImage& image);
+	void writeBlock(FILE* file, int tag, const int* data, int size);
+	string mPath;
+	long mInterval, mLastWrite;										// Milliseconds
+	vector<OneMachDPNode*> mPending;								// Open nodes not yet in the file
+	vector<int> mPendingBuf;										// Records of spilled nodes not yet in the file
+	vector<int> mDeleted;											// Journaled nodes closed since the last write
+	long long mNumBufNodes;											// Nodes in mPendingBuf
+	long long mJournalBytes;										// Size of the file
+	long long mNumRecords, mRecordBytes;							// Node records written, and their bytes
+	int mContourKey;												// Contour the cycle is at, MaxInt for none
+	int mDiveState;													// Node ID explored next by a dive, -1 diving without one, -2 not diving
+};
+
+/************************************************************************************************************
+ * Hands new incumbents to a file or callback on its own thread, so the search never waits on the sink		*
+ ************************************************************************************************************/
+class OneMachDPStream
+{
+public:
+	OneMachDPStream() {}
+	OneMachDPStream(OneMachDPData* omdp) : mOneMachDPData(omdp) {}
+	void initialize(const string& path, incumbentCallback callback);
+	void post(incumbentEvent& event);
+	void finish();
+
+	bool mActive;
+	int mNumPosted;
+	OneMachDPData* mOneMachDPData;
+private:
+	void run();
+	void write(FILE* file, const incumbentEvent& event);
+	string mPath;
+	incumbentCallback mCallback;
+	mutex mLock;
+	condition_variable mReady;
+	deque<incumbentEvent> mQueue;
+	bool mDone;
+	thread mWorker;
+};
+
+/************************************************************************************************************
+ * Binary search tree trace. The search thread copies each record into a ring buffer, and a writer thread	*
+ * drains it to the file in batches. The search only blocks when the ring is full							*
+ ************************************************************************************************************/
+class OneMachDPTrace
+{
+public:
+	OneMachDPTrace() {}
+	OneMachDPTrace(OneMachDPData* omdp) : mOneMachDPData(omdp) {}
+	void initialize(const string& path);
+	void record(const traceRecord& rec);
+	void finish();
+	static const int Capacity = 1 << 15;		// Records in the ring, a power of two
+	static const int FlushBatch = 1 << 12;		// Records pending before the writer is woken
+
+	bool mActive;
+	long long mNumStalls;						// Times the search waited for the writer
+	OneMachDPData* mOneMachDPData;
+	atomic<long long> mHead, mTail;				// Records written by the search, and by the writer
+private:
+	void run();
+	string mPath;
+	vector<traceRecord> mRing;
+	mutex mLock;
+	condition_variable mReady, mSpace;
+	atomic<bool> mDone;
+	thread mWorker;
+};
+
+/************************************************************************************************************
+ * Progress report. The search publishes its counters with relaxed atomic stores once per iteration, and	*
+ * a reporter thread reads them every interval, so the search never waits on output							*
+ ************************************************************************************************************/
+class OneMachDPProgress
+{
+public:
+	OneMachDPProgress() {}
+	OneMachDPProgress(OneMachDPData* omdp) : mOneMachDPData(omdp) {}
+	void initialize(double interval, const string& path);
+	void publish();
+	void finish();
+
+	bool mActive;
+	int mNumReports;
+	OneMachDPData* mOneMachDPData;
+private:
+	void run();
+	void report(FILE* file, double rate);
+	double mInterval;
+	string mPath;
+	atomic<int> mIter, mNodes, mOpen, mGlobLB, mGlobUB, mContour;
+	atomic<long> mElapsed;
+	atomic<long long> mOpenBytes;
+	mutex mLock;
+	condition_variable mWake;
+	bool mDone;
+	thread mWorker;
+};
+
+/************************************************************************************************************
+ * Search timeline in the Chrome trace event format, viewable in Perfetto or chrome://tracing. Every k-th	*
+ * node explored is sampled: its solveNode span, and in builds with OMDP_PROFILE the spans of its phases.	*
+ * New incumbents are instant events and are always written												*
+ ************************************************************************************************************/
+class OneMachDPTimeline
+{
+public:
+	OneMachDPTimeline() {}
+	OneMachDPTimeline(OneMachDPData* omdp) : mOneMachDPData(omdp) {}
+	void initialize(const string& path, int every);
+	void beginNode(int iter);
+	void endNode(OneMachDPNode* node, int flag);
+	void span(const char* name, myclock::time_point start, myclock::time_point end);
+	void incumbent(int makespan, int iter);
+	void finish();
+
+	bool mActive;
+	bool mSampled;								// The node in process is sampled
+	int mNumEvents;
+	OneMachDPData* mOneMachDPData;
+private:
+	double micros(myclock::time_point time) { return chrono::duration<double, micro>(time - mOrigin).count(); }
+	void event(const char* name, const char* cat, myclock::time_point start, myclock::time_point end);
+	FILE* mFile;
+	int mEvery;
+	int mNodeIter;
+	myclock::time_point mOrigin, mNodeStart;
+};
+
 class OneMachDPUtil
 {
 public:
@@ -3,6 +3,19 @@
 OneMachDPData::OneMachDPData(const char* filename)
 {
 	ifstream inFile(filename);
+	readInstance(inFile);
+}
+
+/************************************************************************************************************
+ * Instance from a stream in the format of the instance files, for instances built in memory				*
+ ************************************************************************************************************/
+OneMachDPData::OneMachDPData(istream& inStream)
+{
+	readInstance(inStream);
+}
+
+void OneMachDPData::readInstance(istream& inFile)
+{
 	int head, body, tail, job;
 	int fix, from, to, delay;
 	getline(inFile, mOneMachineName);
@@ -13,6 +26,16 @@ OneMachDPData::OneMachDPData(const char* filename)
 	mTimeLim = 3600;
 	mIterLim = 100000;
 	mTerminateMode = -1;
+	mRevChkOn = true;
+	mCombineOn = false;
+	mLazyOn = false;
+	mMemBudget = 0;
+	mBudgetLossy = false;
+	mSpillBytes = 0;
+	mSpillDir = ".";
+	mIsRev = false;
+	mShared = nullptr;
+	mSyncedUB = MaxInt;
 	for (job = 0; job < numJobs; job++) {
 		if (inFile.eof()) {
 			printf("Something is wrong. Job read stop at: %d\n", job);
@@ -23,21 +46,59 @@ OneMachDPData::OneMachDPData(const char* filename)
 		mInitHead.push_back(head);
 		mInitTail.push_back(tail);
 		mInitFixDPDelay[job].resize(numJobs, 0);
-		//printf("Job %d has head %d, body %d, tail %d.\n", job, head, body, tail);
+		OMDP_LOG(LogTrace, "Job %d has head %d, body %d, tail %d.\n", job, head, body, tail);
 	}
 	if (!inFile.eof()) {
 		inFile >> numInitFix;
 		for (fix = 0; fix < numInitFix; fix++) {
 			inFile >> from >> to >> delay;
-			mInitFix.push_back(fixedEdge(getJobStep(from), getJobStep(to), delay));
+			mInitFix.push_back(fixedEdge(from, to, delay));
 			mInitFixDPDelay[from][to] = delay;
-			//printf("Job %d precedes job %d, with DP at %d.\n", from, to, delay);
+			OMDP_LOG(LogTrace, "Job %d precedes job %d, with DP at %d.\n", from, to, delay);
 		}
 	} else {
 		numInitFix = 0;
 	}
 }
 
+/************************************************************************************************************
+ * Build the reverse problem of org: heads and tails swapped, precedence arcs reversed						*
+ ************************************************************************************************************/
+OneMachDPData::OneMachDPData(OneMachDPData* org)
+{
+	mOneMachineName = org->mOneMachineName;
+	numJobs = org->numJobs;
+	numInitFix = org->numInitFix;
+	mInitFixDPDelay.resize(numJobs);
+	mMode = org->mMode;
+	mTbMode = org->mTbMode;
+	mTimeLim = org->mTimeLim;
+	mIterLim = org->mIterLim;
+	mTerminateMode = -1;
+	mRevChkOn = org->mRevChkOn;
+	mCombineOn = org->mCombineOn;
+	mLazyOn = org->mLazyOn;
+	mMemBudget = org->mMemBudget;
+	mBudgetLossy = org->mBudgetLossy;
+	mSpillBytes = org->mSpillBytes;
+	mSpillDir = org->mSpillDir;
+	mIsRev = !org->mIsRev;
+	mShared = nullptr;
+	mSyncedUB = MaxInt;
+	for (auto job = org->mJobsData.begin(); job != org->mJobsData.end(); job++) {
+		int index = (*job).jobIndex;
+		mJobsData.push_back(JobStep(index, (*job).body, org->mInitTail[index], org->mInitHead[index]));
+		mInitHead.push_back(org->mInitTail[index]);
+		mInitTail.push_back(org->mInitHead[index]);
+		mInitFixDPDelay[index].resize(numJobs, 0);
+	}
+	for (auto fix = org->mInitFix.begin(); fix != org->mInitFix.end(); fix++) {
+		int from = (*fix).to, to = (*fix).from;
+		mInitFix.push_back(fixedEdge(from, to, (*fix).delay));
+		mInitFixDPDelay[from][to] = (*fix).delay;
+	}
+}
+
 /************************************************************************************************************
  * Initialization of options																				*
  ************************************************************************************************************/
@@ -48,6 +109,27 @@ void OneMachDPData::initialize(options* opt)
 	globUB = MaxInt;
 	globLB = initLB = 0;
 	mNumLLTH = 0;
+	mRevNumIter = 0;
+	mSolvedByRev = false;
+	bstFoundAtIter = bstFoundCritSize = 0;
+	numInserted = 0;
+	numBulkPruned = 0;
+	mNumLazyReinsert = 0;
+	mOpenBytes = mPeakOpenBytes = mMaxNodeBytes = 0;
+	for (int c = 0; c < NumMemCategories; c++)
+		mMemBytes[c] = mPeakMemBytes[c] = 0;
+	mPeakMemTotal = mNodeBytesAtPeak = 0;
+	mNumInMemory = mInMemoryAtPeak = 0;
+	mMemLimit = (opt != nullptr) ? opt->memLimit : 0;
+#ifdef OMDP_PROFILE
+	mProfile.mHwRequested = opt != nullptr && opt->hwCounters;
+#endif
+	mDiving = false;
+	mNumDives = mNumDiveIter = 0;
+	mNumDropped = 0;
+	mDroppedLB = MaxInt;
+	mDiveNext = nullptr;
+	prunedAtUB = MaxInt;
 	// control parameters
 	mMesrBest = 1;
 	//mCombineOnRev = false;
@@ -63,21 +145,79 @@ void OneMachDPData::initialize(options* opt)
 		mTbMode = opt->tb;
 		mRevChkOn = opt->revChk;
 		mCombineOn = opt->heuChk;
+		mLazyOn = opt->lazyBound;
+		mMemBudget = opt->memBudget;
+		mBudgetLossy = opt->memBudgetLossy;
+		mSpillBytes = opt->spillBytes;
+		mSpillDir = opt->spillDir;
+	}
+	// Open nodes over a budget that keeps them all are paged out like spilled nodes
+	if (mMemBudget > 0 && !mBudgetLossy && (mSpillBytes == 0 || mMemBudget < mSpillBytes))
+		mSpillBytes = mMemBudget;
+	// The reverse search of a bidirectional run is not checkpointed, it restarts from its root
+	mResume = opt != nullptr && opt->resume && !mIsRev;
+	mRng.seed(opt != nullptr && opt->seed != 0 ? opt->seed : (unsigned int)rand());
+	mTargetGap = (opt != nullptr) ? opt->targetGap : 0;
+	// The reverse search of a bidirectional run takes the warm start through the shared incumbent
+	if (opt != nullptr && !mIsRev)
+		mInitOrder = opt->initOrder;
+	mWarmUB = MaxInt;
+	// Restarts only change the search with ARB tie breaking, the other rules would repeat the same run
+	mRestart = (opt != nullptr && mTbMode == ARB && mMode != DFS) ? opt->restart : NoRestart;
+	if (opt != nullptr) {
+		mRestartBase = opt->restartBase;
+		mRestartFactor = opt->restartFactor;
 	}
+	mNumRestarts = 0;
+	mRunStartIter = mRunStartNodes = 0;
+	mRunBudget = (mRestart != NoRestart) ? restartBudget(0) : MaxInt;
+	mProvenLB = 0;
+	mRestartStats.clear();
 	for (auto job = mJobsData.begin(); job != mJobsData.end(); job++) {
 		mJobsByIndex[(*job).jobIndex] = &(*job);
 	}
+	// Instance invariants, shared read-only by all modules
+	mIndex = new OneMachDPIndex(this);
 	// Initialize Modules here
 	mComputeBounds = new OneMachDPBounds(this);
-	mRevCritPathes = new OneMachDPCritPath(this);
 	mCritPathes = new OneMachDPCritPath(this);
 	mBranching = new OneMachDPBranch(this);
 	mPost = new OneMachDPPost(this);
+	mSpill = new OneMachDPSpill(this);
+	mCheckpoint = new OneMachDPCheckpoint(this);
+	mStream = new OneMachDPStream(this);
+	mTrace = new OneMachDPTrace(this);
+	mProgress = new OneMachDPProgress(this);
+	mTimeline = new OneMachDPTimeline(this);
 	mComputeBounds->initialize();
 	mCritPathes->initialize();
-	mRevCritPathes->initialize();
 	mBranching->initialize();
 	mPost->initialize();
+	mSpill->initialize();
+	if (opt != nullptr && !mIsRev)
+		mCheckpoint->initialize(opt->ckptFile, opt->ckptInterval);
+	else
+		mCheckpoint->initialize("", 0);
+	// Incumbents of the reverse search reach the stream through the forward one
+	if (opt != nullptr && !mIsRev)
+		mStream->initialize(opt->streamFile, opt->onIncumbent);
+	else
+		mStream->initialize("", nullptr);
+	if (opt != nullptr && !mIsRev)
+		mTrace->initialize(opt->traceFile);
+	else
+		mTrace->initialize("");
+	if (opt != nullptr && !mIsRev)
+		mProgress->initialize(opt->progressInterval, opt->progressFile);
+	else
+		mProgress->initialize(0, "");
+	if (opt != nullptr && !mIsRev)
+		mTimeline->initialize(opt->timelineFile, opt->timelineEvery);
+	else
+		mTimeline->initialize("", 1);
+#ifdef OMDP_PROFILE
+	mProfile.mTimeline = mTimeline->mActive ? mTimeline : nullptr;
+#endif
 }
 
 /************************************************************************************************************
@@ -88,20 +228,33 @@ int OneMachDPData::solve()
 	// In each iteration, first explore the next subproblem by using
 	// getNextNode(), then generate new nodes if necessary, delete the explored
 	// one, and move on to the next iteration.
-	myclock::time_point beginning = myclock::now();
 	myclock::duration d;
 	int flag, tempLB;
-	OneMachDPNode* root = new OneMachDPNode(this);
-
 	OneMachDPNode* curNode;
-	addNode(root);
-	//mBstSolNode = new OneMachDPNode(root);
-	setIterator();
+	ALLOC_SCOPE(mProfile, profOther);
+	// A resumed search starts from the open nodes of the checkpoint, and keeps its elapsed time
+	long doneTime = mCheckpoint->start(mResume);
+	mStartTime = myclock::now() - chrono::milliseconds(doneTime);
+#ifdef OMDP_PROFILE
+	// Counters count the thread that opens them, which is the one running this search
+	mProfile.openCounters();
+#endif
+	if (!mResume) {
+		// Warm start: the given order prunes from the first node on
+		if (!mInitOrder.empty())
+			seedIncumbent(mInitOrder);
+		OneMachDPNode* root = new OneMachDPNode(this);
+		addNode(root);
+		//mBstSolNode = new OneMachDPNode(root);
+		setIterator();
+	}
 	while (numToExplore > 0) {
 
 		// Termination check: time limit
-		d = myclock::now() - beginning;
+		d = myclock::now() - mStartTime;
 		mElapsTime = chrono::duration_cast<std::chrono::milliseconds>(d).count();
+		if (mProgress->mActive)
+			mProgress->publish();
 		if ( (mElapsTime / 1000) > mTimeLim) {
 			mTerminateMode = 2;
 			dumpAllNodes();
@@ -113,84 +266,309 @@ int OneMachDPData::solve()
 			dumpAllNodes();
 			return globUB;
 		}
+		// Termination check: concurrent search terminated, otherwise take its incumbent if better
+		if (mShared != nullptr) {
+			if (mShared->stop) {
+				mTerminateMode = 4;
+				dumpAllNodes();
+				return globUB;
+			}
+			syncIncumbent();
+		}
+		// Restart from the root with a new RNG stream once the run has used its node budget
+		if (mRestart != NoRestart && numIter - mRunStartIter >= mRunBudget)
+			restart();
+		// Termination check: target relative gap reached
+		if (mTargetGap > 0 && globUB < MaxInt && globUB - globLB <= mTargetGap * globUB) {
+			mTerminateMode = 5;
+			dumpAllNodes();
+			return globUB;
+		}
+		// Hard memory limit: end the search like the time limit, the checkpoint keeps it resumable
+		if ((numIter & 255) == 0)
+			measureOpenList();
+		if (mMemLimit > 0 && memTotal() > mMemLimit) {
+			mTerminateMode = 3;
+			dumpAllNodes();
+			return globUB;
+		}
+		// No node is in process here, so dominated nodes can be freed at once
+		if (globUB < prunedAtUB)
+			pruneOpenNodes();
+		if (numToExplore == 0)
+			break;
+		// External memory: spill nodes of the largest LBs when over the limit or the memory budget,
+		// and page runs back in when their LB comes up
+		if (mSpillBytes > 0 && mMode != DFS) {
+			if (mOpenBytes > mSpillBytes)
+				mSpill->spill();
+			mSpill->loadDue();
+		}
+		// Checkpoint between iterations, when no node is in process
+		if (mCheckpoint->due(mElapsTime))
+			mCheckpoint->write(mElapsTime);
+		// Memory bounded search: a push over budget starts a dive (addNode). The dive returns to best
+		// first at the end of its path, once open nodes are under budget
+		if (mDiving && mDiveNext == nullptr && mOpenBytes < mMemBudget)
+			mDiving = false;
 
 		curNode = getNextNode();
+		// Lazy bounding: a child is bounded when first selected, and goes back to the open list
+		// when its bound is worse than the key it was queued with
+		if (!curNode->mBounded && curNode->mLBound < globUB) {
+			tempLB = mBranching->boundChild(curNode);
+			mRexSolCount.add(curNode->mRexSol);
+			if (tempLB > curNode->mLBound) {
+				rekeyNode(curNode, tempLB);
+				if (tempLB < globUB && mMode != DFS) {
+					mNumLazyReinsert++;
+					revToPrevContour();
+					continue;
+				}
+			}
+		}
 		if (curNode->mLBound < globUB) {
-			//if (numIter % 10 == 0)
-			//	printf("NID    Iter    NLB     rexSol     feaSol    nFix    cLen    gLB    gUB    contr  \n");
+			if (numIter % 10 == 0)
+				OMDP_LOG(LogTrace, "NID    Iter    NLB     rexSol     feaSol    nFix    cLen    gLB    gUB    contr  \n");
+			if (mTimeline->mActive)
+				mTimeline->beginNode(numIter);
 			flag = solveNode(curNode);
-			//switch (flag) {
-			//case 0:
-			//	printf("%d    %d    %d    %d    %d    %d    %d    %d    %d    %d  \n",
-			//		curNode->mNodeID, numIter, curNode->mLBound, curNode->mRexSol, curNode->mFeaSol, curNode->allFixes.size(),
-			//		curNode->mCritPath.size(), globLB, globUB, curNode->mContour);
-			//	printf("At iter: %d, feasible solution %d found.\n", numIter, curNode->mFeaSol);
-			//	break;
-			//case 1:
-			//	printf("%d    %d    %d    %d    %d    %d    %d    %d    %d    %d  \n",
-			//		curNode->mNodeID, numIter, curNode->mLBound, curNode->mRexSol, curNode->mFeaSol, curNode->allFixes.size(),
-			//		curNode->mCritPath.size(), globLB, globUB, curNode->mContour);
-			//	printf("At iter: %d, strong branching is applied on node %d.\n",
-			//		numIter, curNode->mNodeID);
-			//	break;
-			//case 2:
-			//	printf("%d    %d    %d    %d    %d    %d    %d    %d    %d    %d  \n",
-			//		curNode->mNodeID, numIter, curNode->mLBound, curNode->mRexSol, curNode->mFeaSol, curNode->allFixes.size(),
-			//		curNode->mCritPath.size(), globLB, globUB, curNode->mContour);
-			//	printf("At iter: %d, weak branching case 1 is applied on node %d.\n",
-			//		numIter, curNode->mNodeID);
-			//	break;
-			//case 3:
-			//	printf("%d    %d    %d    %d    %d    %d    %d    %d    %d    %d  \n",
-			//		curNode->mNodeID, numIter, curNode->mLBound, curNode->mRexSol, curNode->mFeaSol, curNode->allFixes.size(),
-			//		curNode->mCritPath.size(), globLB, globUB, curNode->mContour);
-			//	printf("At iter: %d, weak branching case 2 is applied on node %d.\n",
-			//		numIter, curNode->mNodeID);
-			//	break;
-			//case 4:
-			//	printf("%d    %d    %d    %d    %d    %d    %d    %d    %d    %d  \n",
-			//		curNode->mNodeID, numIter, curNode->mLBound, curNode->mRexSol, -1, curNode->allFixes.size(),
-			//		-1, globLB, globUB, curNode->mContour);
-			//	printf("At iter: %d, node LB %d exceed global upper bound, node %d will be pruned.\n",
-			//		numIter, curNode->mRexSol, curNode->mNodeID);
-			//	break;
-			//}
-
-			//if (mInfoFile != nullptr) {
-			//	fprintf(mInfoFile, "%d    %d    %d    %d    %d    %d    %d    %d    %d    %d    %d    %d  \n", numIter,
-			//		flag, curNode->mNodeID, curNode->mLBound, curNode->mRexSol, curNode->mFeaSol, curNode->allFixes.size(),
-			//		curNode->mCritPath.size(), globLB, globUB, curNode->mContour, curNode->mDepth);
-			//	if (flag == 1 || flag == 2 || flag == 3)
-			//		fprintf(mInfoFile, "%d    %d    %d    %d    %d  \n", numIter, flag, curNode->mNodeID,
-			//			mBranching->curLeft, mBranching->curRight);
-			//}
+			if (mTimeline->mActive)
+				mTimeline->endNode(curNode, flag);
+			if (OMDP_LOG_ENABLED(LogTrace)) {
+				bool pruned = (flag == 4);
+				OMDP_LOG(LogTrace, "%d    %d    %d    %d    %d    %d    %d    %d    %d    %d  \n",
+					curNode->mNodeID, numIter, curNode->mLBound, curNode->mRexSol, pruned ? -1 : curNode->mFeaSol, (int)curNode->allFixes.size(),
+					pruned ? -1 : (int)curNode->mCritPath.size(), globLB, globUB, curNode->mContour);
+				switch (flag) {
+				case 0:
+					OMDP_LOG(LogTrace, "At iter: %d, feasible solution %d found.\n", numIter, curNode->mFeaSol);
+					break;
+				case 1:
+					OMDP_LOG(LogTrace, "At iter: %d, strong branching is applied on node %d.\n", numIter, curNode->mNodeID);
+					break;
+				case 2:
+					OMDP_LOG(LogTrace, "At iter: %d, weak branching case 1 is applied on node %d.\n", numIter, curNode->mNodeID);
+					break;
+				case 3:
+					OMDP_LOG(LogTrace, "At iter: %d, weak branching case 2 is applied on node %d.\n", numIter, curNode->mNodeID);
+					break;
+				case 4:
+					OMDP_LOG(LogTrace, "At iter: %d, node LB %d exceed global upper bound, node %d will be pruned.\n",
+						numIter, curNode->mRexSol, curNode->mNodeID);
+					break;
+				}
+			}
+
+			if (mTrace->mActive)
+				traceNode(curNode, flag);
 			//printInfo(curNode);
 
 			numIter++;
 		} else {
-			//printf("At iter: %d, parent LB %d exceed global upper bound, node %d will be pruned.\n",
-			//	numIter, curNode->mLBound, curNode->mNodeID);
+			OMDP_LOG(LogTrace, "At iter: %d, parent LB %d exceed global upper bound, node %d will be pruned.\n",
+				numIter, curNode->mLBound, curNode->mNodeID);
 			// If pruned without exploration, flag is set at 5
 			flag = 5;
 			revToPrevContour();
-			//if (mInfoFile != nullptr) {
-			//	fprintf(mInfoFile, "%d    %d    %d    %d    %d    %d    %d    %d  \n", numIter, flag, curNode->mNodeID,
-			//		curNode->mLBound, globLB, globUB, curNode->mContour, curNode->mDepth);
-			//}
+			if (mTrace->mActive)
+				traceNode(curNode, flag);
 		}
 
 		if (numIter != 1) {
 			tempLB = getCurLB();
+			if (tempLB > mDroppedLB)
+				tempLB = mDroppedLB;
+			if (tempLB < mProvenLB)
+				tempLB = mProvenLB;
 			if (tempLB <= globUB)
 				globLB = tempLB;
 		}
 
 		delete curNode;
 	}
+	measureOpenList();
+	// Nodes dropped over a lossy memory budget were never explored, the gap to their LB is not closed
+	if (mDroppedLB < globUB) {
+		globLB = (mDroppedLB > mProvenLB) ? mDroppedLB : mProvenLB;
+		mTerminateMode = 6;
+		mCheckpoint->close(mElapsTime);
+		return globUB;
+	}
+	// Open list exhausted, either explored or pruned, so the incumbent is optimal
+	globLB = globUB;
 	mTerminateMode = 0;
+	mCheckpoint->close(mElapsTime);
+	return globUB;
+}
+
+/************************************************************************************************************
+ * Solve instance with forward search in this thread and reverse search in a second thread. Both share		*
+ * the incumbent, and both stop when one of them terminates													*
+ ************************************************************************************************************/
+int OneMachDPData::solveBiDir(options* opt)
+{
+	sharedIncumbent shared;
+	OneMachDPData* rev = new OneMachDPData(this);
+	rev->setOutJson(nullptr);
+	rev->setOutSolPath(nullptr);
+	rev->setOutCritPath(nullptr);
+	rev->setOutInfo(nullptr);
+	rev->initialize(opt);
+	mShared = &shared;
+	rev->mShared = &shared;
+	mSyncedUB = rev->mSyncedUB = MaxInt;
+
+	thread revThread([rev, &shared]() {
+		rev->solve();
+		rev->publishIncumbent();
+		shared.stop = true;
+	});
+	solve();
+	publishIncumbent();
+	shared.stop = true;
+	revThread.join();
+
+	// Take the final incumbent, and combine termination information
+	syncIncumbent();
+	mRevNumIter = rev->numIter;
+	if (rev->mTerminateMode == 0 && mTerminateMode != 0) {
+		mSolvedByRev = true;
+		mTerminateMode = 0;
+	} else if (mTerminateMode == 4) {
+		mTerminateMode = rev->mTerminateMode;
+	}
+	if (mTerminateMode == 0)
+		globLB = globUB;
+	else if (rev->globLB > globLB)
+		globLB = rev->globLB;
+	mShared = nullptr;
+	rev->mShared = nullptr;
+	rev->cleanUp();
+	delete rev;
 	return globUB;
 }
 
+/************************************************************************************************************
+ * Take the shared incumbent when it is better than the current one. The shared value only decreases, so	*
+ * each shared incumbent is evaluated once																	*
+ ************************************************************************************************************/
+void OneMachDPData::syncIncumbent()
+{
+	if (mShared->ub >= globUB || mShared->ub == mSyncedUB)
+		return;
+	vector<int> order;
+	{
+		lock_guard<mutex> guard(mShared->lock);
+		order = mShared->bstOrder;
+		mSyncedUB = mShared->ub;
+	}
+	if (mIsRev)
+		reverse(order);
+	list<JobStep*> path;
+	for (int jobIndex : order)
+		path.push_back(mJobsByIndex[jobIndex]);
+	// Evaluate in this direction, the value is never worse than the shared one
+	int sol = calSolution(path);
+	if (sol < globUB) {
+		globUB = sol;
+		mBstSolPath = path;
+		streamIncumbent();
+		if (sol < mShared->ub)
+			publishIncumbent();
+	}
+}
+
+/************************************************************************************************************
+ * Pass the current incumbent to the stream, and mark it on the timeline									*
+ ************************************************************************************************************/
+void OneMachDPData::streamIncumbent()
+{
+	if (mTimeline->mActive)
+		mTimeline->incumbent(globUB, numIter);
+	if (!mStream->mActive)
+		return;
+	incumbentEvent event;
+	event.makespan = globUB;
+	event.iter = numIter;
+	event.elapsed = chrono::duration_cast<std::chrono::milliseconds>(myclock::now() - mStartTime).count();
+	event.order.reserve(mBstSolPath.size());
+	for (auto iter = mBstSolPath.begin(); iter != mBstSolPath.end(); iter++)
+		event.order.push_back((*iter)->jobIndex);
+	mStream->post(event);
+}
+
+/************************************************************************************************************
+ * Trace record of node after solveNode, or after it was pruned on its parent bound with flag 5				*
+ ************************************************************************************************************/
+void OneMachDPData::traceNode(OneMachDPNode* node, int flag)
+{
+	traceRecord rec;
+	bool solved = (flag < 4);
+	rec.iter = numIter;
+	rec.flag = flag;
+	rec.nodeID = node->mNodeID;
+	rec.LB = node->mLBound;
+	rec.rexSol = (flag < 5) ? node->mRexSol : -1;
+	rec.feaSol = solved ? node->mFeaSol : -1;
+	rec.numFix = (flag < 5) ? (int)node->allFixes.size() : -1;
+	rec.critLen = solved ? (int)node->mCritPath.size() : -1;
+	rec.contour = node->mContour;
+	rec.depth = node->mDepth;
+	rec.left = (flag >= 1 && flag <= 3) ? mBranching->curLeft : -1;
+	rec.right = (flag >= 1 && flag <= 3) ? mBranching->curRight : -1;
+	mTrace->record(rec);
+}
+
+/************************************************************************************************************
+ * Take a given job order as incumbent. It must be a permutation of the jobs that keeps every initial		*
+ * precedence arc, DPCs included, and is evaluated like any schedule found by the search					*
+ ************************************************************************************************************/
+void OneMachDPData::seedIncumbent(const vector<int>& order)
+{
+	vector<int> pos(numJobs, -1);
+	if ((int)order.size() != numJobs)
+		throw ERROR << "Initial order has " << (int)order.size() << " jobs, the instance has " << numJobs << ".";
+	for (int i = 0; i < (int)order.size(); i++) {
+		if (order[i] < 0 || order[i] >= numJobs || pos[order[i]] != -1)
+			throw ERROR << "Initial order is not a permutation of the jobs.";
+		pos[order[i]] = i;
+	}
+	for (auto iter = mInitFix.begin(); iter != mInitFix.end(); iter++) {
+		if (pos[(*iter).from] > pos[(*iter).to])
+			throw ERROR << "Initial order violates the arc from job " << (*iter).from << " to job " << (*iter).to << ".";
+	}
+	list<JobStep*> path;
+	for (int jobIndex : order)
+		path.push_back(mJobsByIndex[jobIndex]);
+	mWarmUB = calSolution(path);
+	if (mWarmUB < globUB) {
+		globUB = mWarmUB;
+		mBstSolPath = path;
+		bstFoundAtIter = 0;
+		streamIncumbent();
+		publishIncumbent();
+	}
+}
+
+/************************************************************************************************************
+ * Share current incumbent when it is better than the shared one											*
+ ************************************************************************************************************/
+void OneMachDPData::publishIncumbent()
+{
+	if (mShared == nullptr || globUB >= mShared->ub)
+		return;
+	lock_guard<mutex> guard(mShared->lock);
+	if (globUB >= mShared->ub)
+		return;
+	mShared->bstOrder.clear();
+	for (auto iter = mBstSolPath.begin(); iter != mBstSolPath.end(); iter++)
+		mShared->bstOrder.push_back((*iter)->jobIndex);
+	if (mIsRev)
+		reverse(mShared->bstOrder);
+	mShared->ub = globUB;
+}
+
 /************************************************************************************************************
  * Explore node																								*
  * return value: 0 optimal																					*
@@ -201,6 +579,7 @@ int OneMachDPData::solve()
  ************************************************************************************************************/
 int OneMachDPData::solveNode(OneMachDPNode* node)
 {
+	PROFILE_SCOPE(mProfile, profSolveNode);
 	int flag, uBound, BrchScn;
 	int redoCount = 0;
 	bool useNLT;
@@ -218,7 +597,11 @@ int OneMachDPData::solveNode(OneMachDPNode* node)
 	do {
 		useNLT = false;					// initialize useNLT indicator for the use of new heuristic
 
-		node->updateEdge();
+		// Full head/tail update on first pass, afterwards only re-propagate jobs touched by post processing
+		if (redoCount == 0)
+			node->updateEdge();
+		else
+			node->updateEdge(mPost->mNewPredJobs, mPost->mTailUpdtJobs);
 		node->doedge();
 		resetTailUpdateChk();			// reset all tail update check for all job steps
 		// regular LT algorithm schedule
@@ -289,11 +672,13 @@ int OneMachDPData::solveNode(OneMachDPNode* node)
 	
 	// Get Branching Scenario for current node
 	BrchScn = node->branchingScenario();
-	// If weak branching is the only option, check reverse problem when reverse check is on
+	// If weak branching is the only option, check reverse problem when reverse check is on.
+	// A reverse schedule taken by node replaces the forward one, with its own branching scenario.
 	if (BrchScn > 1 && mRevChkOn) {
 		int revBrchScn = solveRevNode(node);
-		if (revBrchScn == 0 || revBrchScn == 1) {
+		if (revBrchScn >= 0) {
 			BrchScn = revBrchScn;
+			useNLT = false;
 			mBranching->increRevCount();
 		}
 	}
@@ -313,6 +698,8 @@ int OneMachDPData::solveNode(OneMachDPNode* node)
 		mBstSolPath = node->mSolPath;
 		bstFoundAtIter = numIter;
 		bstFoundCritSize = node->mCritPath.size();
+		streamIncumbent();
+		publishIncumbent();
 		//mBstSolNode->copyNode(node);
 	}
 
@@ -321,13 +708,12 @@ int OneMachDPData::solveNode(OneMachDPNode* node)
 		mComputeBounds->getLBStd(node);
 		globLB = node->mRexSol;
 		initLB = globLB;
-		mRexSolCount[globLB] = 1;
+		mRexSolCount.add(globLB);
 	}
 	flag = mBranching->main(node, BrchScn);
 
 	// Clean up
 	mCritPathes->clearPathes();
-	mRevCritPathes->clearPathes();
 	node->undoedge();
 		
 	return flag;
@@ -385,56 +771,320 @@ int OneMachDPData::chkDelayJobCritPathes(OneMachDPNode* node)
 }
 
 /************************************************************************************************************
- * Reverse heads and tail of input node, solve that to get an alternative schedule							*
+ * Reverse heads and tail of input node, solve that to get an alternative schedule. The node takes it only	*
+ * when its makespan is smaller, and the branching scenario of the new schedule is returned; -1 otherwise	*
  ************************************************************************************************************/
 int OneMachDPData::solveRevNode(OneMachDPNode* node) 
 {
-	int revBrchScn;
-	OneMachDPCritPath* temp;
-	OneMachDPNode* rev = node->revNode();
-	OneMachDPNode* repNode = new OneMachDPNode();
-	mUtil->copyNodeBasic(node, repNode);
-
-	// Solve the reverse problem, and reverse the resulting schedule to get a good feasbile schedule for original problem
-	rev->doedge();
-	mComputeBounds->getUB(rev);
-	(rev->mSolPath).reverse();
-
-	// Give this schedule to repNode (this node will have currect order of precedence and updated parameter)
-	repNode->isInMap = false;
-	repNode->mSolPath = rev->mSolPath;
-	// Reset job parameters
-	node->doedge();
-	// This step updates the node currect mJobScheduled array
-	repNode->mFeaSol = calSolution(repNode);
-
-	// Get all critical path for this schedule
-	mRevCritPathes->main(repNode);
-	// Post still needed but will not trigger rework even if tail has changed
-	//mUtil->swapCritPathes(mCritPathes, mRevCritPathes);
-	temp = mCritPathes;
-	mCritPathes = mRevCritPathes;
-	mRevCritPathes = temp;
-
-	mPost->main(repNode);
-	printf("Start checking reverse problem solution...\n");
-	// Get branching scenario for repNode
-	revBrchScn = repNode->branchingScenario();
-	// If scenario is optimal or strong branching, then accept this solution
-	if (revBrchScn == 0 || revBrchScn == 1) {
-		// when reverse branching is used, we need to update node with new schedule
-		// mJobScheduled is not updated to reduce work
-		mUtil->copyNodeSolInfo(repNode, node);
+	PROFILE_SCOPE(mProfile, profSolveRev);
+	list<JobStep*> revSolPath;
+
+	// Schedule of the reverse problem, solved on the node's own heads and tails with their roles swapped.
+	// Heads and tails of the job steps are back to those of node afterwards.
+	mComputeBounds->getUBRev(node, revSolPath);
+	if (calSolution(revSolPath) >= node->mFeaSol)
+		return -1;
+
+	// Node takes the reverse schedule, and post processing works on it as on a forward schedule. The order
+	// is kept when post updates tails, only heads and tails are propagated again.
+	node->mSolPath.swap(revSolPath);
+	while (true) {
+		node->mFeaSol = calSolution(node);
+		node->fillInPos();
+		mCritPathes->main(node);
+		if (!mPost->main(node))
+			break;
+		node->updateEdge(mPost->mNewPredJobs, mPost->mTailUpdtJobs);
+		node->doedge();
+		resetTailUpdateChk();
+	}
+	OMDP_LOG(LogDebug, "Start checking reverse problem solution...\n");
+	return node->branchingScenario();
+}
+
+/************************************************************************************************************
+ * Heap of open nodes in a contour, mHeapPos of each node follows its entry									*
+ ************************************************************************************************************/
+void OneMachDPHeap::push(const heapEntry& entry)
+{
+	mEntries.push_back(entry);
+	entry.node->mHeapPos = mEntries.size() - 1;
+	siftUp(mEntries.size() - 1);
+}
+
+void OneMachDPHeap::erase(OneMachDPNode* node)
+{
+	int pos = node->mHeapPos;
+	if (pos < 0 || pos >= (int)mEntries.size() || mEntries[pos].node != node)
+		throw ERROR << "Cannot locate node in contour.";
+	node->mHeapPos = -1;
+	heapEntry last = mEntries.back();
+	mEntries.pop_back();
+	if (pos == (int)mEntries.size())
+		return;
+	place(pos, last);
+	if (pos > 0 && mEntries[pos] < mEntries[(pos - 1) / 4])
+		siftUp(pos);
+	else
+		siftDown(pos);
+}
+
+void OneMachDPHeap::place(int pos, const heapEntry& entry)
+{
+	mEntries[pos] = entry;
+	entry.node->mHeapPos = pos;
+}
+
+void OneMachDPHeap::siftUp(int pos)
+{
+	heapEntry entry = mEntries[pos];
+	while (pos > 0) {
+		int parent = (pos - 1) / 4;
+		if (!(entry < mEntries[parent]))
+			break;
+		place(pos, mEntries[parent]);
+		pos = parent;
+	}
+	place(pos, entry);
+}
+
+void OneMachDPHeap::siftDown(int pos)
+{
+	int size = mEntries.size();
+	heapEntry entry = mEntries[pos];
+	while (true) {
+		int child = pos * 4 + 1;
+		if (child >= size)
+			break;
+		int end = (child + 4 < size) ? child + 4 : size;
+		int best = child;
+		for (int i = child + 1; i < end; i++) {
+			if (mEntries[i] < mEntries[best])
+				best = i;
+		}
+		if (!(mEntries[best] < entry))
+			break;
+		place(pos, mEntries[best]);
+		pos = best;
+	}
+	place(pos, entry);
+}
+
+/************************************************************************************************************
+ * Counter of bound values, the dense array grows to cover new values										*
+ ************************************************************************************************************/
+void OneMachDPCounter::add(int value, int num)
+{
+	if (mDense && (mCounts.empty() || value < mBase || (long long)value >= (long long)mBase + (long long)mCounts.size()))
+		grow(value);
+	if (mDense)
+		mCounts[value - mBase] += num;
+	else
+		mSparse[value] += num;
+	if (value < mMin)
+		mMin = value;
+	mTotal += num;
+}
+
+bool OneMachDPCounter::remove(int value)
+{
+	if (count(value) <= 0)
+		return false;
+	mTotal--;
+	if (!mDense) {
+		if (--mSparse[value] == 0)
+			mSparse.erase(value);
+		mMin = mSparse.empty() ? MaxInt : mSparse.begin()->first;
+		return true;
+	}
+	mCounts[value - mBase]--;
+	if (mTotal == 0) {
+		mMin = MaxInt;
+	} else if (value == mMin) {
+		// Only moves up, each slot is passed once until a smaller value is added
+		while (mCounts[mMin - mBase] == 0)
+			mMin++;
+	}
+	return true;
+}
+
+int OneMachDPCounter::min()
+{
+	return mMin;
+}
+
+int OneMachDPCounter::count(int value) const
+{
+	if (!mDense) {
+		auto iter = mSparse.find(value);
+		return (iter == mSparse.end()) ? 0 : iter->second;
+	}
+	if (mCounts.empty() || value < mBase || (long long)value >= (long long)mBase + (long long)mCounts.size())
+		return 0;
+	return mCounts[value - mBase];
+}
+
+int OneMachDPCounter::countBelow(int value) const
+{
+	int sum = 0;
+	if (!mDense) {
+		for (auto iter = mSparse.begin(); iter != mSparse.end() && iter->first < value; iter++)
+			sum += iter->second;
+		return sum;
+	}
+	for (int i = 0; i < (int)mCounts.size() && (long long)mBase + i < value; i++)
+		sum += mCounts[i];
+	return sum;
+}
+
+int OneMachDPCounter::countAbove(int value) const
+{
+	return mTotal - countBelow(value) - count(value);
+}
+
+long long OneMachDPCounter::memBytes() const
+{
+	return (long long)mCounts.capacity() * sizeof(int) + (long long)mSparse.size() * (MAP_NODE_BYTES + sizeof(LBMap::value_type));
+}
+
+void OneMachDPCounter::histogram(vector<pair<int, int>>& out) const
+{
+	out.clear();
+	if (!mDense) {
+		out.assign(mSparse.begin(), mSparse.end());
+		return;
+	}
+	for (int i = 0; i < (int)mCounts.size(); i++) {
+		if (mCounts[i] > 0)
+			out.push_back(pair<int, int>(mBase + i, mCounts[i]));
+	}
+}
+
+void OneMachDPProfile::clear()
+{
+	for (int phase = 0; phase < NumProfPhases; phase++) {
+		mTotalNs[phase] = mCalls[phase] = 0;
+		for (int b = 0; b < NumBuckets; b++)
+			mBuckets[phase][b] = 0;
+		for (int e = 0; e < NumHwEvents; e++)
+			mHw[phase][e] = 0;
+		mAllocs[phase] = mAllocBytes[phase] = 0;
+	}
+	for (int e = 0; e < NumHwEvents; e++)
+		mHwSlot[e] = -1;
+	mHwEnabled = mHwRunning = 0;
+}
+
+void OneMachDPProfile::addHw(int phase, const long long* delta)
+{
+	for (int e = 0; e < NumHwEvents; e++)
+		mHw[phase][e] += delta[e];
+}
+
+profileScope::~profileScope()
+{
+	myclock::time_point end = myclock::now();
+#ifdef OMDP_ALLOC_PROFILE
+	tAllocProfile = mPrevProfile;
+	tAllocPhase = mPrevPhase;
+#endif
+	mProf.add(mPhase, chrono::duration_cast<chrono::nanoseconds>(end - mStart).count());
+	if (mProf.mHwActive) {
+		long long endHw[NumHwEvents];
+		mProf.readCounters(endHw);
+		for (int e = 0; e < NumHwEvents; e++)
+			endHw[e] -= mStartHw[e];
+		mProf.addHw(mPhase, endHw);
+	}
+	// The timeline writes the solveNode span itself, with the node's values
+	if (mProf.mTimeline != nullptr && mProf.mTimeline->mSampled && mPhase != profSolveNode)
+		mProf.mTimeline->span(OneMachDPProfile::phaseName(mPhase), mStart, end);
+}
+
+/************************************************************************************************************
+ * Values below 8 have a bucket each; above, bucket is 8 + 4 per power of two from 8 on, plus the two bits	*
+ * after the leading one																					*
+ ************************************************************************************************************/
+void OneMachDPProfile::add(int phase, long long ns)
+{
+	int bucket, lg = 3;
+	mTotalNs[phase] += ns;
+	mCalls[phase]++;
+	if (ns < 8) {
+		bucket = (ns < 0) ? 0 : (int)ns;
 	} else {
-		// otherwise switch critpathes back
-		//mUtil->swapCritPathes(mCritPathes, mRevCritPathes);
-		temp = mCritPathes;
-		mCritPathes = mRevCritPathes;
-		mRevCritPathes = temp;
+		while ((ns >> lg) > 1)
+			lg++;
+		bucket = 8 + (lg - 3) * 4 + (int)((ns >> (lg - 2)) & 3);
 	}
-	delete rev;
-	delete repNode;
-	return revBrchScn;
+	mBuckets[phase][bucket]++;
+}
+
+/************************************************************************************************************
+ * Lower end of the bucket holding the p quantile, within a quarter of its power of two						*
+ ************************************************************************************************************/
+long long OneMachDPProfile::percentile(int phase, double p) const
+{
+	long long rank = (long long)(p * mCalls[phase]), seen = 0;
+	for (int b = 0; b < NumBuckets; b++) {
+		seen += mBuckets[phase][b];
+		if (seen > rank || (seen == mCalls[phase] && seen > 0)) {
+			if (b < 8)
+				return b;
+			int lg = (b - 8) / 4 + 3;
+			return (long long)(4 + (b - 8) % 4) << (lg - 2);
+		}
+	}
+	return 0;
+}
+
+const char* OneMachDPProfile::phaseName(int phase)
+{
+	static const char* names[NumProfPhases] = { "updateEdge", "getUB", "getUBMod2", "critPath", "post", "branchingScenario",
+		"solveRevNode", "branch", "getLBStd", "solveNode", "other" };
+	return names[phase];
+}
+
+int OneMachDPLog::mLevel = OMDP_LOG_LEVEL;
+FILE* OneMachDPLog::mFile = stdout;
+
+void OneMachDPLog::write(const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	vfprintf(mFile, format, args);
+	va_end(args);
+}
+
+/************************************************************************************************************
+ * Extend the dense array to value, doubling its span; switch to the map when the span is too wide			*
+ ************************************************************************************************************/
+void OneMachDPCounter::grow(int value)
+{
+	if (mCounts.empty()) {
+		mBase = value;
+		mCounts.assign(64, 0);
+		return;
+	}
+	long long lo = mBase, hi = (long long)mBase + mCounts.size();
+	long long span = hi - lo;
+	if (value < lo)
+		lo = std::max(std::min(lo - span, (long long)value), (long long)MinInt);
+	else
+		hi = std::min(std::max(hi + span, (long long)value + 1), (long long)MaxInt + 1);
+	if (hi - lo > MaxDenseSpan) {
+		for (int i = 0; i < (int)mCounts.size(); i++) {
+			if (mCounts[i] > 0)
+				mSparse[mBase + i] = mCounts[i];
+		}
+		mCounts.clear();
+		mDense = false;
+		return;
+	}
+	vector<int> counts(hi - lo, 0);
+	copy(mCounts.begin(), mCounts.end(), counts.begin() + (mBase - lo));
+	mCounts.swap(counts);
+	mBase = (int)lo;
 }
 
 /************************************************************************************************************
@@ -442,7 +1092,67 @@ int OneMachDPData::solveRevNode(OneMachDPNode* node)
  ************************************************************************************************************/
 void OneMachDPData::addNode(OneMachDPNode* node)
 {
-	int best;
+	attachNode(node);
+	mLowerBd.add(node->mLBound);
+	// Lazy children are counted once bounded
+	if (node->mDepth != 0 && node->mBounded)
+		mRexSolCount.add(node->mRexSol);
+	if (node->mDepth > maxDepth)
+		maxDepth = node->mDepth;
+	// Under a budget the best child of the node in process is kept, it is explored next while diving
+	if (mMemBudget > 0 && mMode != DFS && (mDiveNext == nullptr || node->mLBound < mDiveNext->mLBound))
+		mDiveNext = node;
+	numToExplore++;
+	numNodes++;
+	mCheckpoint->nodeAdded(node);
+	if (mMemBudget > 0 && mMode != DFS && mOpenBytes > mMemBudget)
+		enforceBudget(node);
+}
+
+/************************************************************************************************************
+ * Open nodes went over the memory budget after a push, the search dives. The surplus is paged out between	*
+ * iterations by the spill, or with a lossy budget open nodes of the largest LB are dropped at once. A		*
+ * dropped node is never explored, its LB bounds globLB through mDroppedLB until the incumbent reaches it.	*
+ * The parent of the pushed node is in process and is not dropped											*
+ ************************************************************************************************************/
+void OneMachDPData::enforceBudget(OneMachDPNode* pushed)
+{
+	if (!mDiving) {
+		mDiving = true;
+		mNumDives++;
+	}
+	if (!mBudgetLossy)
+		return;
+	while (mOpenBytes > mMemBudget) {
+		OneMachDPNode* drop = nullptr;
+		for (auto bucket = mOpenByLB.rbegin(); bucket != mOpenByLB.rend() && drop == nullptr; bucket++) {
+			for (auto iter = bucket->second.rbegin(); iter != bucket->second.rend(); iter++) {
+				if ((*iter)->mNodeID != pushed->mParentID) {
+					drop = *iter;
+					break;
+				}
+			}
+		}
+		if (drop == nullptr)
+			return;
+		if (drop->mLBound < globUB) {
+			if (drop->mLBound < mDroppedLB)
+				mDroppedLB = drop->mLBound;
+			mNumDropped++;
+		} else {
+			numBulkPruned++;
+		}
+		// delete removes the node from its contour, its LB bucket and mLowerBd
+		delete drop;
+	}
+}
+
+/************************************************************************************************************
+ * Heap key of a node: measure of best, then the key of the tie breaking rule								*
+ ************************************************************************************************************/
+heapEntry OneMachDPData::makeHeapEntry(OneMachDPNode* node)
+{
+	int best, tie;
 	// choice of measure of best function: lower bound / parent feasible solution
 	switch (mMesrBest) {
 	case 1:
@@ -454,167 +1164,143 @@ void OneMachDPData::addNode(OneMachDPNode* node)
 	default:
 		best = node->mLBound;
 	}
-	if (mMode == DFS) {
-		mNodesStack.push(node);
-	} else {
-		node->mContour = calContour(node);
-		mContours[node->mContour].insert({ best, node });
+	// A node back from a spill run or a checkpoint keeps the key it was first queued with
+	if (node->mHeapSeq >= 0)
+		return heapEntry(best, node->mTieKey, node->mHeapSeq, node);
+	// choice of tie breaking rules
+	switch (mTbMode) {
+	case FIFO:
+		tie = 0;
+		break;
+	case LIFO:
+		tie = -numInserted;
+		break;
+	case MinParent:
+		tie = node->mParentSol;
+		break;
+	case ARB:
+		// Arbitrary tie breaking, random key drawn once at insertion
+		tie = (int)(mRng() >> 1);
+		break;
+	default:
+		tie = -numInserted;
+		break;
 	}
+	node->mTieKey = tie;
+	node->mHeapSeq = numInserted;
+	return heapEntry(best, tie, numInserted++, node);
+}
 
-	int lb = node->mLBound;
-	if (mLowerBd.count(lb) == 0) {
-		mLowerBd[lb] = 1;
-	} else {
-		mLowerBd[lb]++;
+void OneMachDPData::addToLBBucket(OneMachDPNode* node)
+{
+	vector<OneMachDPNode*>& bucket = mOpenByLB[node->mLBound];
+	node->mLBPos = bucket.size();
+	bucket.push_back(node);
+}
+
+void OneMachDPData::removeFromLBBucket(OneMachDPNode* node)
+{
+	auto bucket = mOpenByLB.find(node->mLBound);
+	if (bucket == mOpenByLB.end() || node->mLBPos < 0 || bucket->second[node->mLBPos] != node)
+		throw ERROR << "Cannot locate node in LB bucket.";
+	OneMachDPNode* last = bucket->second.back();
+	bucket->second[node->mLBPos] = last;
+	last->mLBPos = node->mLBPos;
+	bucket->second.pop_back();
+	node->mLBPos = -1;
+	if (bucket->second.empty())
+		mOpenByLB.erase(bucket);
+}
+
+/************************************************************************************************************
+ * Change LB of an open node, it stays in its contour so the contour iterators remain valid					*
+ ************************************************************************************************************/
+void OneMachDPData::rekeyNode(OneMachDPNode* node, int newLB)
+{
+	if (!mLowerBd.remove(node->mLBound))
+		throw ERROR << "Cannot locate search item.";
+	if (mMode != DFS) {
+		removeFromLBBucket(node);
+		mContours[node->mContour].erase(node);
 	}
-	int rs = node->mRexSol;
-	if (node->mDepth != 0)
-	{
-		if (mRexSolCount.count(rs) == 0)
-			mRexSolCount[rs] = 1;
-		else
-			mRexSolCount[rs]++;
+	node->mLBound = newLB;
+	if (mMode != DFS) {
+		// Queued again, with a new key
+		node->mHeapSeq = -1;
+		mContours[node->mContour].push(makeHeapEntry(node));
+		addToLBBucket(node);
 	}
-	if (node->mDepth > maxDepth)
-		maxDepth = node->mDepth;
-	numToExplore++;
-	numNodes++;
+	mLowerBd.add(newLB);
 }
 
 OneMachDPNode* OneMachDPData::getNextNode()
 {
-	int n;
 	OneMachDPNode* out;
-	vector<OneMachDPNode*> candidates;
+	// While diving the contour is not advanced, the node stays in its heap until deleted
+	out = mDiveNext;
+	mDiveNext = nullptr;
+	if (mDiving && out != nullptr) {
+		mPreContour = mCurContour;
+		mNumDiveIter++;
+		return out;
+	}
 	// NOTE: what if we don't update mCurContour every iteration?
 	if (mMode == DFS) {
 		out = mNodesStack.top();
 		mNodesStack.pop();
-	}
-	else {
+	} else {
 		mPreContour = mCurContour;
-		++mCurContour;
-		if (mCurContour == mContours.end())
+		if (mCurContour == mContours.end() || ++mCurContour == mContours.end())
 			mCurContour = mContours.begin();
-		// There should always be a node in here
-		int search;
-		search = ((mCurContour->second).begin())->first;
-		auto range = mCurContour->second.equal_range(search);
-		// choice of tie breaking rules
-		switch (mTbMode) {
-		case FIFO:
-			// FIFO tie breaking
-			out = (range.first)->second;
-			break;
-		case MinParent:
-			// Tie breaking by choosing the one with the smallest mParentSol
-			out = (range.first)->second;
-			for (auto iter = range.first; iter != range.second; iter++) {
-				if ((iter->second)->mParentSol < out->mParentSol)
-					out = iter->second;
-			}
-			break;
-		case LIFO:
-			// LIFO tie breaking
-			out = (--range.second)->second;
-			break;
-		case ARB:
-			// Arbitrary Tie Breaking
-			for (auto iter = range.first; iter != range.second; iter++)
-				candidates.push_back(iter->second);
-			n = rand() % candidates.size();
-			out = candidates[n];
-			break;
-		default:
-			// LIFO tie breaking
-			out = (--range.second)->second;
-			break;
-		}
+		// There should always be a node in here, ties are already broken by the heap order
+		out = mCurContour->second.top();
 	}
 	return out;
 }
 
-OneMachDPNode* OneMachDPData::getNextNode(tbMode tbRule)
+void OneMachDPData::delNode(OneMachDPNode* toDelete)
+{
+	detachNode(toDelete);
+	if (!mLowerBd.remove(toDelete->mLBound))
+		throw ERROR << "Cannot locate search item.";
+	numToExplore--;
+	mCheckpoint->nodeDeleted(toDelete);
+}
+
+/************************************************************************************************************
+ * Place node in memory part of open list: its contour heap and LB bucket, or the stack for DFS. Counting	*
+ * in mLowerBd and numToExplore is left to the caller, since spilled nodes stay counted					*
+ ************************************************************************************************************/
+void OneMachDPData::attachNode(OneMachDPNode* node)
 {
-	int n;
-	OneMachDPNode* out;
-	vector<OneMachDPNode*> candidates;
-	// NOTE: what if we don't update mCurContour every iteration?
 	if (mMode == DFS) {
-		out = mNodesStack.top();
-		mNodesStack.pop();
+		mNodesStack.push(node);
 	} else {
-		mPreContour = mCurContour;
-		++mCurContour;
-		if (mCurContour == mContours.end())
-			mCurContour = mContours.begin();
-		// There should always be a node in here
-		int search;
-		search = ((mCurContour->second).begin())->first;
-		auto range = mCurContour->second.equal_range(search);
-		// choice of tie breaking rules
-		switch (tbRule) {
-		case FIFO:
-			// FIFO tie breaking
-			out = (range.first)->second;
-			break;
-		case MinParent:
-			// Tie breaking by choosing the one with the smallest mParentSol
-			out = (range.first)->second;
-			for (auto iter = range.first; iter != range.second; iter++) {
-				if ((iter->second)->mParentSol < out->mParentSol)
-					out = iter->second;
-			}
-			break;
-		case LIFO:
-			// LIFO tie breaking
-			out = (--range.second)->second;
-			break;
-		case ARB:
-			// Arbitrary Tie Breaking
-			for (auto iter = range.first; iter != range.second; iter++)
-				candidates.push_back(iter->second);
-			n = rand() % candidates.size();
-			out = candidates[n];
-			break;
-		default:
-			// LIFO tie breaking
-			out = (--range.second)->second;
-			break;
-		}
+		node->mContour = calContour(node);
+		mContours[node->mContour].push(makeHeapEntry(node));
+		addToLBBucket(node);
 	}
-	return out;
+	long long bytes = node->memBytes(node->mBytes);
+	mOpenBytes += bytes;
+	if (bytes > mMaxNodeBytes)
+		mMaxNodeBytes = bytes;
+	if (mOpenBytes > mPeakOpenBytes)
+		mPeakOpenBytes = mOpenBytes;
+	for (int c = 0; c < NumNodeMem; c++)
+		mMemBytes[c] += node->mBytes[c];
+	mNumInMemory++;
+	updateMemPeak();
 }
 
-void OneMachDPData::delNode(OneMachDPNode* toDelete)
+void OneMachDPData::detachNode(OneMachDPNode* toDelete)
 {
-	int search;
-	switch (mMesrBest) {
-	case 1:
-		search = toDelete->mLBound;
-		break;
-	case 2:
-		search = toDelete->mParentSol;
-		break;
-	default:
-		search = toDelete->mLBound;
-		break;
-	}
 	if (mMode == DFS) {
 
 	} else {
-		//int search = toDelete->mParentSol;	
 		int targetCont = toDelete->mContour;
-		auto range = mContours[targetCont].equal_range(search);
-
-		// Find the nodes that has the same Measure of Best, then find the one with the exact nodeID.
-		// I'm still not sure whether I can clear memory by deleting iter (a pointer to the OneMachNode)
-		for (auto iter = range.first; iter != range.second; iter++) {
-			if ((iter->second)->mNodeID == toDelete->mNodeID) {
-				mContours[targetCont].erase(iter);
-				break;
-			}
-		}
+		// The node knows its own position in the heap of its contour and in its LB bucket
+		mContours[targetCont].erase(toDelete);
+		removeFromLBBucket(toDelete);
 		if (mContours[targetCont].empty()) {
 			if (mCurContour == mContours.find(targetCont)) {
 				if (mCurContour == mContours.begin())
@@ -622,39 +1308,175 @@ void OneMachDPData::delNode(OneMachDPNode* toDelete)
 				mCurContour--;
 			}
 			mContours.erase(targetCont);
+			// No contour left in memory (nodes spilled), the next pick starts from the first contour
+			if (mContours.empty())
+				mCurContour = mContours.end();
 		}
 	}
+	if (toDelete == mDiveNext)
+		mDiveNext = nullptr;
+	for (int c = 0; c < NumNodeMem; c++) {
+		mMemBytes[c] -= toDelete->mBytes[c];
+		mOpenBytes -= toDelete->mBytes[c];
+	}
+	mNumInMemory--;
+}
 
-	int lb = toDelete->mLBound;
-	if (mLowerBd.count(lb) == 1 && mLowerBd[lb] > 0) {
-		mLowerBd[lb]--;
-		if (mLowerBd[lb] == 0)
-			mLowerBd.erase(lb);
-	} else {
-		throw ERROR << "Cannot locate search item.";
+/************************************************************************************************************
+ * Bytes of the open list structures and histograms. They change with every node, so they are measured		*
+ * every few iterations instead of being kept up to date													*
+ ************************************************************************************************************/
+void OneMachDPData::measureOpenList()
+{
+	long long bytes = (long long)mNodesStack.size() * sizeof(OneMachDPNode*);
+	for (auto iter = mContours.begin(); iter != mContours.end(); iter++)
+		bytes += MAP_NODE_BYTES + sizeof(ContourMap::value_type) + iter->second.memBytes();
+	mMemBytes[memContours] = bytes;
+	bytes = 0;
+	for (auto iter = mOpenByLB.begin(); iter != mOpenByLB.end(); iter++)
+		bytes += MAP_NODE_BYTES + sizeof(LBBuckets::value_type) + iter->second.capacity() * sizeof(OneMachDPNode*);
+	mMemBytes[memLBBuckets] = bytes;
+	mMemBytes[memHistograms] = mLowerBd.memBytes() + mRexSolCount.memBytes();
+	updateMemPeak();
+}
+
+void OneMachDPData::updateMemPeak()
+{
+	long long total = memTotal();
+	for (int c = 0; c < NumMemCategories; c++) {
+		if (mMemBytes[c] > mPeakMemBytes[c])
+			mPeakMemBytes[c] = mMemBytes[c];
 	}
-	numToExplore--;
+	if (total > mPeakMemTotal) {
+		mPeakMemTotal = total;
+		mNodeBytesAtPeak = mOpenBytes;
+		mInMemoryAtPeak = mNumInMemory;
+	}
+}
+
+long long OneMachDPData::memTotal()
+{
+	long long total = 0;
+	for (int c = 0; c < NumMemCategories; c++)
+		total += mMemBytes[c];
+	return total;
+}
+
+const char* OneMachDPData::memName(int category)
+{
+	static const char* names[NumMemCategories] = { "nodeObjects", "fixes", "adjacency", "schedules", "paths", "contours", "LBBuckets",
+		"histograms" };
+	return names[category];
 }
 
 int OneMachDPData::getCurLB() 
 {
-	auto lbIter = mLowerBd.begin();
-	int lb = lbIter->first;
-	int count = lbIter->second;
-	if (count <= 0)
+	if (mLowerBd.total() <= 0)
 		throw ERROR << "Retrive global lower bound error.";
-	return lb;
+	return mLowerBd.min();
 }
 
 void OneMachDPData::dumpAllNodes() 
 {
+	// Save the search before its open list is dropped, so it can be resumed with larger limits
+	mCheckpoint->close(mElapsTime);
+	clearOpenNodes();
+	measureOpenList();
+}
+
+void OneMachDPData::clearOpenNodes()
+{
+	mSpill->dropAll();
 	while (numToExplore > 0) {
-		// When dumping, use the simplest tie breaking rule
-		OneMachDPNode* curNode = getNextNode(FIFO);
+		// When dumping, order does not matter
+		OneMachDPNode* curNode = getNextNode();
 		delete curNode;
 	}
 }
 
+/************************************************************************************************************
+ * Drop the open list and start a new run from the root. The incumbent is kept, and so is the LB proven by	*
+ * the runs so far, which bounds the new root																*
+ ************************************************************************************************************/
+void OneMachDPData::restart()
+{
+	restartStat stat;
+	stat.budget = mRunBudget;
+	stat.iter = numIter - mRunStartIter;
+	stat.nodes = numNodes - mRunStartNodes;
+	stat.ub = globUB;
+	stat.lb = globLB;
+	stat.elapsed = mElapsTime;
+	mRestartStats.push_back(stat);
+	if (globLB > mProvenLB)
+		mProvenLB = globLB;
+
+	clearOpenNodes();
+	mDiving = false;
+	mDiveNext = nullptr;
+	// The proven LB already accounts for dropped nodes
+	mDroppedLB = MaxInt;
+	mNumRestarts++;
+	mRunStartIter = numIter;
+	mRunStartNodes = numNodes;
+	mRunBudget = restartBudget(mNumRestarts);
+	// Next RNG stream is drawn from the current one, so a seeded search stays reproducible
+	mRng.seed(mRng());
+	// Incumbent proven optimal, the open list stays empty
+	if (mProvenLB >= globUB)
+		return;
+	OneMachDPNode* root = new OneMachDPNode(this);
+	root->mNodeID = increaseNodeID();
+	root->mLBound = mProvenLB;
+	addNode(root);
+	setIterator();
+}
+
+/************************************************************************************************************
+ * Node budget of run number run, counted from 0: base times the Luby sequence 1 1 2 1 1 2 4 ..., or base	*
+ * times factor to the power of run																			*
+ ************************************************************************************************************/
+int OneMachDPData::restartBudget(int run)
+{
+	double budget = mRestartBase;
+	if (mRestart == Luby) {
+		int size = 1, seq = 0;
+		while (size < run + 1) {
+			seq++;
+			size = 2 * size + 1;
+		}
+		while (size - 1 != run) {
+			size = (size - 1) >> 1;
+			seq--;
+			run = run % size;
+		}
+		budget *= pow(2.0, seq);
+	} else {
+		budget *= pow(mRestartFactor, run);
+	}
+	return (budget >= MaxInt) ? MaxInt : (int)budget;
+}
+
+/************************************************************************************************************
+ * Free all open nodes that can not improve on globUB, starting from the largest LB							*
+ ************************************************************************************************************/
+void OneMachDPData::pruneOpenNodes()
+{
+	prunedAtUB = globUB;
+	// Dropped nodes are dominated once the incumbent reaches the smallest of their LBs
+	if (mDroppedLB >= globUB)
+		mDroppedLB = MaxInt;
+	// The stack of DFS can not drop nodes in the middle, those are pruned at pop
+	if (mMode == DFS)
+		return;
+	while (!mOpenByLB.empty() && mOpenByLB.rbegin()->first >= globUB) {
+		// delete removes the node from its contour, its LB bucket and mLowerBd
+		delete mOpenByLB.rbegin()->second.back();
+		numBulkPruned++;
+	}
+	mSpill->pruneRuns();
+}
+
 void OneMachDPData::resetTailUpdateChk() {
 	for (int i = 0; i < numJobs; i++) {
 		mJobsByIndex[i]->isTailUpdated = false;
@@ -733,16 +1555,15 @@ bool OneMachDPData::chkFinalSolution()
 		tail = mInitTail[(*iter)->jobIndex];
 		if (sumPath < head) sumPath = head;
 		sumPath += body;
-		for (int i = 0; i < numJobs; i++) {
-			if (mInitFixDPDelay[curIndex][i] != 0) {
-				temp = sumPath + mInitFixDPDelay[curIndex][i];
-				releaseTime[i] = (releaseTime[i] < temp) ? temp : releaseTime[i];
-			}
+		for (int k = mIndex->mDPCSuccs.begin(curIndex); k < mIndex->mDPCSuccs.end(curIndex); k++) {
+			const fixedEdge& dpc = mIndex->mDPCFix[mIndex->mDPCSuccs.edges[k]];
+			temp = sumPath + dpc.delay;
+			releaseTime[dpc.to] = (releaseTime[dpc.to] < temp) ? temp : releaseTime[dpc.to];
 		}
 		curBst = sumPath + tail;
 		if (curBst > maxTime)
 			maxTime = curBst;
-		//printf("At job %d, curBst is: %d, sumPath is: %d and maxTime is: %d.\n", curIndex, curBst, sumPath, maxTime);
+		OMDP_LOG(LogTrace, "At job %d, curBst is: %d, sumPath is: %d and maxTime is: %d.\n", curIndex, curBst, sumPath, maxTime);
 	}
 	printf("The time in original problem is %d, and the time after BnB is %d.", maxTime, globUB);
 	return (maxTime == globUB);
@@ -775,13 +1596,12 @@ int OneMachDPData::calSolution(OneMachDPNode* node)
 		tail = mInitTail[(*iter)->jobIndex];
 		if (sumPath < head) sumPath = head;
 		node->mJobScheduled[curIndex] = sumPath;
-		//printf("%d  %d  %d  %d  %d\n", curIndex, sumPath, (*iter)->head, body, (*iter)->tail);
+		OMDP_LOG(LogTrace, "%d  %d  %d  %d  %d\n", curIndex, sumPath, (*iter)->head, body, (*iter)->tail);
 		sumPath += body;
-		for (int i = 0; i < numJobs; i++) {
-			if (mInitFixDPDelay[curIndex][i] != 0) {
-				temp = sumPath + mInitFixDPDelay[curIndex][i];
-				releaseTime[i] = (releaseTime[i] < temp) ? temp : releaseTime[i];
-			}
+		for (int k = mIndex->mDPCSuccs.begin(curIndex); k < mIndex->mDPCSuccs.end(curIndex); k++) {
+			const fixedEdge& dpc = mIndex->mDPCFix[mIndex->mDPCSuccs.edges[k]];
+			temp = sumPath + dpc.delay;
+			releaseTime[dpc.to] = (releaseTime[dpc.to] < temp) ? temp : releaseTime[dpc.to];
 		}
 		curBst = sumPath + tail;
 		if (curBst > maxTime)
@@ -811,18 +1631,17 @@ int OneMachDPData::calSolution(list<JobStep*> &solPath)
 		body = (*iter)->body;
 		tail = mInitTail[(*iter)->jobIndex];
 		if (sumPath < head) sumPath = head;
-		//printf("%d %d\n", curIndex, sumPath);
+		OMDP_LOG(LogTrace, "%d %d\n", curIndex, sumPath);
 		sumPath += body;
-		for (int i = 0; i < numJobs; i++) {
-			if (mInitFixDPDelay[curIndex][i] != 0) {
-				temp = sumPath + mInitFixDPDelay[curIndex][i];
-				releaseTime[i] = (releaseTime[i] < temp) ? temp : releaseTime[i];
-			}
+		for (int k = mIndex->mDPCSuccs.begin(curIndex); k < mIndex->mDPCSuccs.end(curIndex); k++) {
+			const fixedEdge& dpc = mIndex->mDPCFix[mIndex->mDPCSuccs.edges[k]];
+			temp = sumPath + dpc.delay;
+			releaseTime[dpc.to] = (releaseTime[dpc.to] < temp) ? temp : releaseTime[dpc.to];
 		}
 		curBst = sumPath + tail;
 		if (curBst > maxTime)
 			maxTime = curBst;
-		//printf("At job %d, curBst is: %d, sumPath is: %d and maxTime is: %d.\n", curIndex, curBst, sumPath, maxTime);
+		OMDP_LOG(LogTrace, "At job %d, curBst is: %d, sumPath is: %d and maxTime is: %d.\n", curIndex, curBst, sumPath, maxTime);
 	}
 	return maxTime;
 }
@@ -859,10 +1678,24 @@ void OneMachDPData::printInfo(OneMachDPNode* curNode)
 void OneMachDPData::cleanUp() 
 {
 	delete mComputeBounds;
-	delete mRevCritPathes;
 	delete mCritPathes;
 	delete mBranching;
 	delete mPost;
+	mSpill->dropAll();
+	delete mSpill;
+	delete mCheckpoint;
+	mStream->finish();
+	delete mStream;
+	mTrace->finish();
+	delete mTrace;
+#ifdef OMDP_PROFILE
+	mProfile.closeCounters();
+#endif
+	mProgress->finish();
+	delete mProgress;
+	mTimeline->finish();
+	delete mTimeline;
+	delete mIndex;
 }
 
 /************************************************************************************************************
@@ -876,7 +1709,7 @@ int OneMachDPData::testHeuristics()
 	setIterator();
 	testHeuRes.clear();
 	testHeuRes.resize(numHeu);
-	OneMachDPNode* curNode = getNextNode(FIFO);
+	OneMachDPNode* curNode = getNextNode();
 	curNode->populateFixes();
 	resetTailUpdateChk();
 	curNode->updateEdge();
@@ -897,12 +1730,6 @@ int OneMachDPData::testHeuristics()
 
 void OneMachDPData::updatePercentage()
 {
-	numLNodes = 0; numGNodes = 0;
-	for (auto iter = mRexSolCount.begin(); iter != mRexSolCount.end(); iter++)
-	{
-		if (iter->first < globUB)
-			numLNodes += iter->second;
-		else if (iter->first > globUB)
-			numGNodes += iter->second;
-	}
+	numLNodes = mRexSolCount.countBelow(globUB);
+	numGNodes = mRexSolCount.countAbove(globUB);
 }
\ No newline at end of file
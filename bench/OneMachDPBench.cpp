@@ -0,0 +1,210 @@
+/************************************************************************************************************
+ * Microbenchmark of the bounding, heuristic and critical path kernels										*
+ *																											*
+ * Build with all solver sources except main.cpp. Instances are generated in memory from a seed, for each	*
+ * number of jobs and precedence density, and every kernel is run on the root node until minTime seconds	*
+ * have passed. One JSON object per line is written for each kernel and instance, then one per kernel and	*
+ * density with the fitted scaling exponent of ns per call against the number of jobs.						*
+ *																											*
+ * Usage: OneMachDPBench [-n 50,100,...] [-d 0,1,2,4] [-s seed] [-t minTime] [-o file]						*
+ ************************************************************************************************************/
+
+#include "../OneMachineDP.h"
+#include "OneMachDPGen.h"
+#include <new>
+
+using namespace std;
+
+// Allocations made through operator new, counted to report allocations per call. The allocation profiling
+// build of the solver has its own operator new, which charges the profile of the instance instead
+#ifdef OMDP_ALLOC_PROFILE
+long long countAllocs(OneMachDPData* data)
+{
+	long long num = 0;
+	for (int phase = 0; phase < NumProfPhases; phase++)
+		num += data->mProfile.mAllocs[phase];
+	return num;
+}
+#else
+static atomic<long long> numAllocs(0);
+
+long long countAllocs(OneMachDPData*)
+{
+	return numAllocs;
+}
+
+void* operator new(size_t size)
+{
+	numAllocs++;
+	void* ptr = malloc(size == 0 ? 1 : size);
+	if (ptr == nullptr)
+		throw bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	free(ptr);
+}
+#endif
+
+typedef struct benchResult
+{
+	string kernel;
+	int numJobs, density;
+	long long calls;
+	double nsPerCall, allocsPerCall;
+} benchResult;
+
+/************************************************************************************************************
+ * Run kernel in batches of doubling size until minTime seconds have passed									*
+ ************************************************************************************************************/
+benchResult timeKernel(OneMachDPData* data, const char* name, int numJobs, int density, double minTime, const function<void()>& kernel)
+{
+	benchResult res;
+	long long batch = 1, allocs = 0;
+	double ns = 0;
+	res.kernel = name;
+	res.numJobs = numJobs;
+	res.density = density;
+	res.calls = 0;
+	kernel();
+	while (ns < minTime * 1e9) {
+		long long startAllocs = countAllocs(data);
+		myclock::time_point start = myclock::now();
+		for (long long i = 0; i < batch; i++)
+			kernel();
+		ns += chrono::duration_cast<chrono::nanoseconds>(myclock::now() - start).count();
+		allocs += countAllocs(data) - startAllocs;
+		res.calls += batch;
+		batch *= 2;
+	}
+	res.nsPerCall = ns / res.calls;
+	res.allocsPerCall = (double)allocs / res.calls;
+	return res;
+}
+
+/************************************************************************************************************
+ * Root node state as solveNode builds it before bounding, then each kernel on that state					*
+ ************************************************************************************************************/
+void benchInstance(int numJobs, int density, unsigned int seed, double minTime, vector<benchResult>& results)
+{
+	stringstream inStream(genInstance(numJobs, density, seed));
+	OneMachDPData* data = new OneMachDPData(inStream);
+	options opt(3600, 100000, BFS, true);
+	opt.tb = FIFO;
+	opt.heuChk = false;
+	data->initialize(&opt);
+
+	OneMachDPNode* node = new OneMachDPNode(data);
+	node->populateFixes();
+	data->resetTailUpdateChk();
+	node->updateEdge();
+	node->doedge();
+	data->resetTailUpdateChk();
+	data->mComputeBounds->getUB(node);
+	node->fillInPos();
+#ifdef OMDP_ALLOC_PROFILE
+	// Allocations outside the profiled phases of the kernels are charged to the first phase
+	tAllocProfile = &data->mProfile;
+#endif
+
+	results.push_back(timeKernel(data, "updateEdge", numJobs, density, minTime, [node]() { node->updateEdge(); }));
+	results.push_back(timeKernel(data, "getLBStd", numJobs, density, minTime, [data, node]() { data->mComputeBounds->getLBStd(node); }));
+	results.push_back(timeKernel(data, "getUB", numJobs, density, minTime, [data, node]() {
+		data->resetTailUpdateChk();
+		data->mComputeBounds->getUB(node);
+	}));
+	results.push_back(timeKernel(data, "calSolution", numJobs, density, minTime, [data, node]() { data->calSolution(node); }));
+	node->fillInPos();
+	// The paths found by main are cleared as after each node in solveNode
+	results.push_back(timeKernel(data, "critPath", numJobs, density, minTime, [data, node]() {
+		data->mCritPathes->main(node);
+		data->mCritPathes->clearPathes();
+	}));
+	results.push_back(timeKernel(data, "getUBMod2", numJobs, density, minTime, [data, node]() {
+		data->resetTailUpdateChk();
+		data->mComputeBounds->getUBMod2(node);
+	}));
+
+#ifdef OMDP_ALLOC_PROFILE
+	tAllocProfile = nullptr;
+#endif
+	node->undoedge();
+	// The root was never put in the open list
+	node->isInMap = false;
+	delete node;
+	data->cleanUp();
+	delete data;
+}
+
+/************************************************************************************************************
+ * Least squares slope of log(ns per call) over log(number of jobs)											*
+ ************************************************************************************************************/
+double scalingExponent(const vector<benchResult>& series)
+{
+	double sx = 0, sy = 0, sxx = 0, sxy = 0;
+	int num = series.size();
+	for (auto iter = series.begin(); iter != series.end(); iter++) {
+		double x = log((double)(*iter).numJobs), y = log((*iter).nsPerCall);
+		sx += x; sy += y; sxx += x * x; sxy += x * y;
+	}
+	if (num < 2 || num * sxx - sx * sx == 0)
+		return 0;
+	return (num * sxy - sx * sy) / (num * sxx - sx * sx);
+}
+
+int main(int argc, char* argv[])
+{
+	vector<int> sizes = { 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+	vector<int> densities = { 0, 1, 2, 4 };
+	unsigned int seed = 1;
+	double minTime = 0.2;
+	FILE* out = stdout;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		string flag = argv[i];
+		if (flag == "-n")
+			sizes = parseList(argv[i + 1]);
+		else if (flag == "-d")
+			densities = parseList(argv[i + 1]);
+		else if (flag == "-s")
+			seed = atoi(argv[i + 1]);
+		else if (flag == "-t")
+			minTime = atof(argv[i + 1]);
+		else if (flag == "-o" && (out = fopen(argv[i + 1], "w")) == nullptr) {
+			printf("Cannot open %s.\n", argv[i + 1]);
+			return 1;
+		}
+	}
+
+	vector<benchResult> results;
+	for (int density : densities) {
+		for (int numJobs : sizes) {
+			size_t first = results.size();
+			benchInstance(numJobs, density, seed, minTime, results);
+			for (size_t i = first; i < results.size(); i++) {
+				fprintf(out, "{\"kernel\": \"%s\", \"n\": %d, \"density\": %d, \"seed\": %u, \"calls\": %lld, \"nsPerCall\": %.1f, \"allocsPerCall\": %.2f}\n",
+					results[i].kernel.c_str(), results[i].numJobs, results[i].density, seed, results[i].calls, results[i].nsPerCall,
+					results[i].allocsPerCall);
+			}
+			fflush(out);
+		}
+	}
+
+	// Scaling curve of each kernel and density
+	map<pair<string, int>, vector<benchResult>> series;
+	for (auto iter = results.begin(); iter != results.end(); iter++)
+		series[pair<string, int>((*iter).kernel, (*iter).density)].push_back(*iter);
+	for (auto iter = series.begin(); iter != series.end(); iter++) {
+		fprintf(out, "{\"kernel\": \"%s\", \"density\": %d, \"scalingExponent\": %.3f}\n", iter->first.first.c_str(), iter->first.second,
+			scalingExponent(iter->second));
+	}
+	if (out != stdout)
+		fclose(out);
+	return 0;
+}
@@ -0,0 +1,62 @@
+/************************************************************************************************************
+ * Seeded instances built in memory, shared by the benchmark programs										*
+ ************************************************************************************************************/
+
+#ifndef ONEMACHDPGEN_H
+#define ONEMACHDPGEN_H
+
+#include "../OneMachineDP.h"
+
+/************************************************************************************************************
+ * Instance text in the format of the instance files, with heads, bodies and tails drawn like				*
+ * genProbAllPrec. Each job gets density arcs on average to jobs of larger index, so arcs never form a		*
+ * cycle and generation stays linear in the number of arcs													*
+ ************************************************************************************************************/
+inline string genInstance(int numJobs, int density, unsigned int seed)
+{
+	int bodyMax = 50, coef = 15, htCoef = 50;
+	int htMax = numJobs * bodyMax * coef / htCoef;
+	mt19937 rng(seed);
+	vector<int> bodies(numJobs);
+	stringstream out;
+	out << "bench_J" << numJobs << "_D" << density << "_S" << seed << "\n" << numJobs << "\n";
+	for (int job = 0; job < numJobs; job++) {
+		bodies[job] = rng() % bodyMax + 1;
+		int head = rng() % htMax + 1;
+		int tail = rng() % htMax + 1;
+		out << head << " " << bodies[job] << " " << tail << "\n";
+	}
+
+	vector<fixedEdge> arcs;
+	for (int from = 0; from + 1 < numJobs; from++) {
+		vector<int> succs;
+		for (int k = 0; k < density; k++) {
+			if (rng() % 2 == 0)
+				continue;
+			succs.push_back(from + 1 + rng() % (numJobs - from - 1));
+		}
+		sort(succs.begin(), succs.end());
+		succs.erase(unique(succs.begin(), succs.end()), succs.end());
+		for (int to : succs) {
+			int delay = (int)(rng() % htMax) + 1 - bodies[from];
+			arcs.push_back(fixedEdge(from, to, (delay > 0) ? delay : delay + bodies[from]));
+		}
+	}
+	out << arcs.size() << "\n";
+	for (auto iter = arcs.begin(); iter != arcs.end(); iter++)
+		out << (*iter).from << " " << (*iter).to << " " << (*iter).delay << "\n";
+	return out.str();
+}
+
+// Comma separated list of integers, as given on the command line
+inline vector<int> parseList(const char* arg)
+{
+	vector<int> values;
+	stringstream in(arg);
+	string item;
+	while (getline(in, item, ','))
+		values.push_back(atoi(item.c_str()));
+	return values;
+}
+
+#endif
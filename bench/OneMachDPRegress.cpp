@@ -0,0 +1,249 @@
+/************************************************************************************************************
+ * End to end performance regression run of the solver														*
+ *																											*
+ * Build with all solver sources except main.cpp. Solves a pinned set of generated instances, one per		*
+ * number of jobs, density and seed, with BFS and FIFO tie breaking so that runs are repeatable. For each	*
+ * instance nodes, iterations, time, peak RSS and final gap are recorded. On Linux each instance is solved	*
+ * in a child process, so its peak RSS is its own. With -b they are compared to a							*
+ * baseline written before with -w, and a metric worse than the baseline by more than the threshold is		*
+ * flagged. With -mb the instances are solved under a memory budget, and one whose open nodes went over	*
+ * the budget by more than one node is flagged. The summary is one JSON object; the exit code is 1 when		*
+ * anything is flagged.																						*
+ *																											*
+ * Usage: OneMachDPRegress [-n 20,30,40,50] [-d 0,1,2] [-s 1,2,3] [-l timeLimit] [-i iterLimit]			*
+ *                         [-r threshold] [-m minTimeMs] [-mb memBudget] [-b baseline] [-w baseline]		*
+ *                         [-o file]																		*
+ ************************************************************************************************************/
+
+#include "../OneMachineDP.h"
+#include "OneMachDPGen.h"
+#include <cstring>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Fields of a record passed from the child process, the name follows them
+typedef struct regressCounts
+{
+	int nodes, iter, terminate;
+	long timeMs, peakRssKB;
+	long long peakOpenBytes, maxNodeBytes;
+	double gap;
+} regressCounts;
+
+typedef struct regressRecord : regressCounts
+{
+	string name;
+} regressRecord;
+
+regressRecord solveInstance(int numJobs, int density, unsigned int seed, double timeLimit, int iterLimit, long long memBudget)
+{
+	regressRecord rec;
+	stringstream inStream(genInstance(numJobs, density, seed));
+	myclock::time_point start = myclock::now();
+	OneMachDPData* data = new OneMachDPData(inStream);
+	options opt(timeLimit, iterLimit, BFS, true);
+	opt.tb = FIFO;
+	opt.heuChk = false;
+	opt.seed = seed;
+	opt.memBudget = memBudget;
+	data->setOutJson(nullptr);
+	data->setOutSolPath(nullptr);
+	data->setOutCritPath(nullptr);
+	data->setOutInfo(nullptr);
+	data->initialize(&opt);
+	data->solve();
+	rec.timeMs = chrono::duration_cast<chrono::milliseconds>(myclock::now() - start).count();
+	rec.peakRssKB = -1;
+	rec.name = data->mOneMachineName;
+	rec.nodes = data->numNodes;
+	rec.iter = data->numIter;
+	rec.terminate = data->mTerminateMode;
+	rec.peakOpenBytes = data->mPeakOpenBytes;
+	rec.maxNodeBytes = data->mMaxNodeBytes;
+	rec.gap = (data->globUB > 0 && data->globUB < MaxInt) ? (double)(data->globUB - data->globLB) / data->globUB : 1;
+	data->cleanUp();
+	delete data;
+	return rec;
+}
+
+/************************************************************************************************************
+ * Solve one instance. On Linux it is solved in a child process, and the peak resident set size in KB is	*
+ * the maximum RSS of the child. Elsewhere it is solved here and the peak is not available, -1				*
+ ************************************************************************************************************/
+regressRecord runInstance(int numJobs, int density, unsigned int seed, double timeLimit, int iterLimit, long long memBudget)
+{
+#ifdef __linux__
+	int fds[2];
+	if (pipe(fds) != 0)
+		throw ERROR << "Cannot create pipe.";
+	fflush(nullptr);
+	pid_t pid = fork();
+	if (pid < 0)
+		throw ERROR << "Cannot fork.";
+	if (pid == 0) {
+		close(fds[0]);
+		regressRecord rec = solveInstance(numJobs, density, seed, timeLimit, iterLimit, memBudget);
+		string out((const char*)(const regressCounts*)&rec, sizeof(regressCounts));
+		out += rec.name;
+		bool done = write(fds[1], out.data(), out.size()) == (ssize_t)out.size();
+		close(fds[1]);
+		_exit(done ? 0 : 1);
+	}
+	close(fds[1]);
+	string in;
+	char buf[4096];
+	ssize_t num;
+	while ((num = read(fds[0], buf, sizeof(buf))) > 0)
+		in.append(buf, num);
+	close(fds[0]);
+	int status;
+	struct rusage usage;
+	if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || in.size() < sizeof(regressCounts))
+		throw ERROR << "Instance J" << numJobs << " D" << density << " S" << (int)seed << " failed.";
+	regressRecord rec;
+	memcpy((regressCounts*)&rec, in.data(), sizeof(regressCounts));
+	rec.name = in.substr(sizeof(regressCounts));
+	rec.peakRssKB = usage.ru_maxrss;
+	return rec;
+#else
+	return solveInstance(numJobs, density, seed, timeLimit, iterLimit, memBudget);
+#endif
+}
+
+/************************************************************************************************************
+ * Baseline file: one line per instance, name nodes iter timeMs peakRssKB gap								*
+ ************************************************************************************************************/
+void writeBaseline(const char* path, const vector<regressRecord>& records)
+{
+	FILE* file = fopen(path, "w");
+	if (file == nullptr)
+		throw ERROR << "Cannot open baseline file " << path;
+	for (auto iter = records.begin(); iter != records.end(); iter++)
+		fprintf(file, "%s %d %d %ld %ld %.6f\n", (*iter).name.c_str(), (*iter).nodes, (*iter).iter, (*iter).timeMs, (*iter).peakRssKB,
+			(*iter).gap);
+	fclose(file);
+}
+
+map<string, regressRecord> readBaseline(const char* path)
+{
+	map<string, regressRecord> baseline;
+	ifstream inFile(path);
+	regressRecord rec;
+	if (!inFile)
+		throw ERROR << "Cannot open baseline file " << path;
+	while (inFile >> rec.name >> rec.nodes >> rec.iter >> rec.timeMs >> rec.peakRssKB >> rec.gap)
+		baseline[rec.name] = rec;
+	return baseline;
+}
+
+/************************************************************************************************************
+ * A count is worse when it grows by more than threshold of the baseline; time also needs to grow by		*
+ * minTimeMs, so timer noise on short runs is not flagged													*
+ ************************************************************************************************************/
+void compare(const regressRecord& cur, const regressRecord& base, double threshold, long minTimeMs, vector<string>& flags)
+{
+	if (cur.nodes > base.nodes * (1 + threshold))
+		flags.push_back("nodes");
+	if (cur.iter > base.iter * (1 + threshold))
+		flags.push_back("iter");
+	if (cur.timeMs > base.timeMs * (1 + threshold) && cur.timeMs - base.timeMs > minTimeMs)
+		flags.push_back("time");
+	if (base.peakRssKB > 0 && cur.peakRssKB > base.peakRssKB * (1 + threshold))
+		flags.push_back("peakRss");
+	if (cur.gap > base.gap + 1e-9)
+		flags.push_back("gap");
+}
+
+int main(int argc, char* argv[])
+{
+	vector<int> sizes = { 20, 30, 40, 50 };
+	vector<int> densities = { 0, 1, 2 };
+	vector<int> seeds = { 1, 2, 3 };
+	double timeLimit = 60, threshold = 0.1;
+	int iterLimit = 100000;
+	long minTimeMs = 20;
+	long long memBudget = 0;
+	const char* basePath = nullptr;
+	const char* writePath = nullptr;
+	FILE* out = stdout;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		string flag = argv[i];
+		if (flag == "-n")
+			sizes = parseList(argv[i + 1]);
+		else if (flag == "-d")
+			densities = parseList(argv[i + 1]);
+		else if (flag == "-s")
+			seeds = parseList(argv[i + 1]);
+		else if (flag == "-l")
+			timeLimit = atof(argv[i + 1]);
+		else if (flag == "-i")
+			iterLimit = atoi(argv[i + 1]);
+		else if (flag == "-r")
+			threshold = atof(argv[i + 1]);
+		else if (flag == "-m")
+			minTimeMs = atol(argv[i + 1]);
+		else if (flag == "-mb")
+			memBudget = atoll(argv[i + 1]);
+		else if (flag == "-b")
+			basePath = argv[i + 1];
+		else if (flag == "-w")
+			writePath = argv[i + 1];
+		else if (flag == "-o" && (out = fopen(argv[i + 1], "w")) == nullptr) {
+			printf("Cannot open %s.\n", argv[i + 1]);
+			return 1;
+		}
+	}
+
+	map<string, regressRecord> baseline;
+	if (basePath != nullptr)
+		baseline = readBaseline(basePath);
+
+	vector<regressRecord> records;
+	for (int numJobs : sizes) {
+		for (int density : densities) {
+			for (int seed : seeds)
+				records.push_back(runInstance(numJobs, density, seed, timeLimit, iterLimit, memBudget));
+		}
+	}
+	if (writePath != nullptr)
+		writeBaseline(writePath, records);
+
+	int numFlagged = 0;
+	fprintf(out, "{\"threshold\": %.3f, \"minTimeMs\": %ld, \"memBudget\": %lld, \"instances\": [", threshold, minTimeMs, memBudget);
+	for (size_t i = 0; i < records.size(); i++) {
+		const regressRecord& rec = records[i];
+		fprintf(out, "%s\n{\"name\": \"%s\", \"nodes\": %d, \"iter\": %d, \"timeMs\": %ld, \"peakRssKB\": %ld, \"gap\": %.6f, \"TerCond\": %d",
+			(i == 0) ? "" : ",", rec.name.c_str(), rec.nodes, rec.iter, rec.timeMs, rec.peakRssKB, rec.gap, rec.terminate);
+		// Open nodes are brought back within the budget after each push, so only the last node may exceed it
+		bool overBudget = memBudget > 0 && rec.peakOpenBytes > memBudget + rec.maxNodeBytes;
+		if (memBudget > 0)
+			fprintf(out, ", \"peakOpenBytes\": %lld, \"maxNodeBytes\": %lld, \"overBudget\": %s", rec.peakOpenBytes, rec.maxNodeBytes,
+				overBudget ? "true" : "false");
+		if (overBudget)
+			numFlagged++;
+		auto base = baseline.find(rec.name);
+		if (base != baseline.end()) {
+			vector<string> flags;
+			compare(rec, base->second, threshold, minTimeMs, flags);
+			fprintf(out, ", \"base\": {\"nodes\": %d, \"iter\": %d, \"timeMs\": %ld, \"peakRssKB\": %ld, \"gap\": %.6f}, \"flags\": [",
+				base->second.nodes, base->second.iter, base->second.timeMs, base->second.peakRssKB, base->second.gap);
+			for (size_t k = 0; k < flags.size(); k++)
+				fprintf(out, "%s\"%s\"", (k == 0) ? "" : ", ", flags[k].c_str());
+			fprintf(out, "]");
+			if (!flags.empty() && !overBudget)
+				numFlagged++;
+		} else if (basePath != nullptr) {
+			fprintf(out, ", \"base\": null");
+		}
+		fprintf(out, "}");
+	}
+	fprintf(out, "],\n\"numInstances\": %d, \"numFlagged\": %d}\n", (int)records.size(), numFlagged);
+	if (out != stdout)
+		fclose(out);
+	return (numFlagged > 0) ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+/************************************************************************************************************
+ * Decoder of the binary search tree trace written with OneMachineDPProblem::setTrace						*
+ *																											*
+ * Builds on its own, without the solver sources. Writes one CSV line per traced node, with the fields of	*
+ * traceRecord in order.																					*
+ *																											*
+ * Usage: OneMachDPTraceCsv trace [csv]																		*
+ ************************************************************************************************************/
+
+#include "../OneMachineDP.h"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2) {
+		printf("Usage: %s trace [csv]\n", argv[0]);
+		return 1;
+	}
+	FILE* in = fopen(argv[1], "rb");
+	if (in == nullptr) {
+		printf("Cannot open %s.\n", argv[1]);
+		return 1;
+	}
+	FILE* out = stdout;
+	if (argc > 2 && (out = fopen(argv[2], "w")) == nullptr) {
+		printf("Cannot open %s.\n", argv[2]);
+		fclose(in);
+		return 1;
+	}
+
+	int header[4];
+	if (fread(header, sizeof(int), 4, in) != 4 || header[0] != TRACE_MAGIC) {
+		printf("%s is not a trace file.\n", argv[1]);
+		return 1;
+	}
+	if (header[1] != TRACE_VERSION || header[2] != sizeof(traceRecord)) {
+		printf("Trace version %d with %d byte records is not supported.\n", header[1], header[2]);
+		return 1;
+	}
+
+	// Records are read in blocks, a trace of a long search does not fit in memory as text
+	vector<traceRecord> block(4096);
+	size_t num;
+	long long total = 0;
+	fprintf(out, "iter,flag,nodeID,LB,rexSol,feaSol,numFix,critLen,contour,depth,left,right\n");
+	while ((num = fread(block.data(), sizeof(traceRecord), block.size(), in)) > 0) {
+		for (size_t i = 0; i < num; i++) {
+			const traceRecord& rec = block[i];
+			fprintf(out, "%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n", rec.iter, rec.flag, rec.nodeID, rec.LB, rec.rexSol, rec.feaSol,
+				rec.numFix, rec.critLen, rec.contour, rec.depth, rec.left, rec.right);
+		}
+		total += num;
+	}
+	fclose(in);
+	if (out != stdout)
+		fclose(out);
+	fprintf(stderr, "%lld records of %d jobs.\n", total, header[3]);
+	return 0;
+}